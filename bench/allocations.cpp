@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include <new>
+#include "bench.hpp"
+
+// Every allocation of the benchmark binary goes through here and gets counted
+namespace
+{
+
+std::atomic<size_t> allocation_count {0};
+
+// Windows has a separate allocator for aligned blocks
+void free_aligned(void* memory)
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+} // namespace
+
+size_t bench::allocations()
+{
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t const size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (auto* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](size_t const size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+// Over-aligned types come through these, they count the same
+void* operator new(size_t const size, std::align_val_t const alignment)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    auto const align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    if (auto* memory = _aligned_malloc(std::max<size_t>(size, 1), align)) return memory;
+#else
+    // aligned_alloc wants a multiple of the alignment
+    auto const rounded = (std::max<size_t>(size, 1) + align - 1) / align * align;
+    if (auto* memory = std::aligned_alloc(align, rounded)) return memory;
+#endif
+    throw std::bad_alloc{};
+}
+
+void* operator new[](size_t const size, std::align_val_t const alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    free_aligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    free_aligned(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+    free_aligned(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept
+{
+    free_aligned(memory);
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+
+namespace bench
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the compiler from throwing away results of the measured code
+template <typename T>
+void keep(T const& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename Func>
+double time_ms(Func&& func)
+{
+    auto const start = Clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Of the timed runs of one measurement, in the unit it is reported in
+struct Summary
+{
+    double median;
+    double mean;
+    double stddev;
+    double min;
+    double max;
+    size_t runs;
+};
+
+[[nodiscard]] Summary summarize(std::vector<double> values);
+
+// Untimed runs first, to fill caches and size buffers, then each timed run is one sample
+struct Repeat
+{
+    size_t warmup{2};
+    size_t runs{15};
+};
+
+// value turns the milliseconds of one run into what gets reported, e.g. nanoseconds per operation
+template <typename Func, typename Value>
+Summary repeat(Func&& func, Value&& value, Repeat const& repeat = {})
+{
+    for (size_t run{}; run < repeat.warmup; ++run) func();
+    std::vector<double> values(repeat.runs);
+    for (auto& run_value : values) run_value = value(time_ms(func));
+    return summarize(std::move(values));
+}
+
+// A table for people, or one JSON object per line for scripts
+enum class Output
+{
+    Text,
+    Json,
+};
+
+void set_output(Output const format);
+void report(std::string_view const suite, std::string_view const name, double const value, std::string_view const unit);
+void report(std::string_view const suite, std::string_view const name, Summary const& summary, std::string_view const unit);
+
+// For results that have to come out right rather than fast. A failed check goes to stderr and makes bench exit with 1
+void check(std::string_view const suite, std::string_view const name, bool const passed);
+[[nodiscard]] bool failed();
+
+// Scratch directory for suites writing files, unique to this process and layout so that suites of both bench
+// binaries, run in parallel by `meson test`, never remove each other's files
+[[nodiscard]] std::filesystem::path temp_directory(std::string_view const suite);
+
+// Heap allocations made by the whole process so far, operator new is replaced to count them
+[[nodiscard]] size_t allocations();
+
+// Suites, one per file
+void camera();
+void chunk();
+void chunk_map();
+void entities();
+void handoff();
+void input();
+void jobs();
+void light();
+void mesher();
+void noise();
+void physics();
+void raycast();
+void region();
+void streaming();
+void writeback();
+
+} // namespace bench
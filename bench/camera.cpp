@@ -0,0 +1,41 @@
+#include <cmath>
+#include "bench.hpp"
+#include "camera.hpp"
+
+namespace
+{
+
+constexpr size_t UPDATES {1 << 16};
+
+// Looking around in circles while moving, once per tick like the world does
+void looking(PerspectiveCamera& camera, size_t const count)
+{
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        auto const step = static_cast<float>(idx);
+        camera.update({step * 0.01f, 80.f, 0.f}, {std::sin(step * 0.05f) * 4.f, std::cos(step * 0.05f) * 2.f});
+    }
+}
+
+} // namespace
+
+void bench::camera()
+{
+    PerspectiveCamera camera{{1920, 1080}};
+    auto const update = bench::repeat([&] {
+        looking(camera, UPDATES);
+        bench::keep(camera.view);
+    }, [](double const ms) { return ms * 1e6 / UPDATES; });
+    bench::report("camera", "update", update, "ns/update");
+
+    // The world culls with a fresh frustum every snapshot
+    auto const frustum = bench::repeat([&] {
+        for (size_t idx{}; idx < UPDATES; ++idx)
+        {
+            camera.update(camera.position, {1.f, 0.f});
+            Frustum const planes{camera};
+            bench::keep(planes.planes);
+        }
+    }, [](double const ms) { return ms * 1e6 / UPDATES; });
+    bench::report("camera", "update and frustum", frustum, "ns/update");
+}
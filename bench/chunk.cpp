@@ -0,0 +1,157 @@
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "terrain.hpp"
+#include "voxel/chunk.hpp"
+
+namespace
+{
+
+constexpr size_t CHUNK_COUNT {1024};
+
+void memory(std::string_view const name, void (*generate)(Chunk&, uint32_t))
+{
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    chunks.reserve(CHUNK_COUNT);
+    auto const elapsed = bench::time_ms([&] {
+        for (size_t idx{}; idx < CHUNK_COUNT; ++idx)
+        {
+            auto& chunk = chunks.emplace_back(std::make_unique<Chunk>(ChunkPos{static_cast<int32_t>(idx), 0}));
+            generate(*chunk, static_cast<uint32_t>(idx));
+            chunk->compact();
+        }
+    });
+
+    size_t total{};
+    for (auto const& chunk : chunks)
+    {
+        total += chunk->memory_usage();
+    }
+    auto const per_chunk = static_cast<double>(total) / CHUNK_COUNT;
+    constexpr double flat_array {SECTION_VOLUME * SECTIONS_PER_CHUNK * sizeof(Block)};
+
+    bench::report("chunk", fmt::format("{} bytes/chunk", name), per_chunk, "B");
+    bench::report("chunk", fmt::format("{} vs flat array", name), flat_array / per_chunk, "x smaller");
+    bench::report("chunk", fmt::format("{} 100k chunks", name), per_chunk * 100'000 / (1024 * 1024), "MiB");
+    bench::report("chunk", fmt::format("{} fill", name), elapsed * 1e6 / (CHUNK_COUNT * SECTION_VOLUME * SECTIONS_PER_CHUNK), "ns/block");
+}
+
+void access()
+{
+    Chunk chunk{{0, 0}};
+    bench::hills(chunk, 42);
+
+    constexpr size_t ops {1 << 22};
+    uint32_t state {1};
+    size_t solid{};
+    auto const per_op = [](double const ms) { return ms * 1e6 / ops; };
+    auto const get = bench::repeat([&] {
+        for (size_t idx{}; idx < ops; ++idx)
+        {
+            state = state * 1664525u + 1013904223u;
+            solid += is_opaque(chunk.get(state & 15, (state >> 8) % CHUNK_HEIGHT, (state >> 4) & 15));
+        }
+    }, per_op);
+    bench::keep(solid);
+
+    auto const set = bench::repeat([&] {
+        for (size_t idx{}; idx < ops; ++idx)
+        {
+            state = state * 1664525u + 1013904223u;
+            chunk.set(state & 15, (state >> 8) % CHUNK_HEIGHT, (state >> 4) & 15, (state >> 20) & 1 ? Block::Stone : Block::Dirt);
+        }
+    }, per_op);
+    bench::keep(chunk);
+
+    bench::report("chunk", "random get", get, "ns/op");
+    bench::report("chunk", "random set", set, "ns/op");
+}
+
+// Same blocks in both layouts: random lookups, the 6 neighbours of random blocks and short walks in random directions
+template <typename Layout>
+void layout(std::string_view const name, Chunk const& source)
+{
+    std::vector<BasicChunkSection<Layout>> sections(SECTIONS_PER_CHUNK);
+    for (int y{}; y < CHUNK_HEIGHT; ++y)
+    {
+        for (int z{}; z < SECTION_SIZE; ++z)
+        {
+            for (int x{}; x < SECTION_SIZE; ++x)
+            {
+                sections[static_cast<size_t>(y / SECTION_SIZE)].set(x, y % SECTION_SIZE, z, source.get(x, y, z));
+            }
+        }
+    }
+    // The surface sections, where rays and collision spend their time
+    std::erase_if(sections, [](auto const& section) { return section.uniform(); });
+
+    constexpr size_t ops {1 << 22};
+    uint32_t state {1};
+    auto const next = [&] {
+        state = state * 1664525u + 1013904223u;
+        return state;
+    };
+    size_t solid{};
+    auto const get_ms = bench::time_ms([&] {
+        for (size_t idx{}; idx < ops; ++idx)
+        {
+            auto const random = next();
+            auto const& section = sections[(random >> 16) % sections.size()];
+            solid += is_opaque(section.get(random & 15, (random >> 8) & 15, (random >> 4) & 15));
+        }
+    });
+
+    auto const neighbours_ms = bench::time_ms([&] {
+        for (size_t idx{}; idx < ops / 6; ++idx)
+        {
+            auto const random = next();
+            auto const& section = sections[(random >> 16) % sections.size()];
+            auto const x = static_cast<int>(random & 15) | 1;
+            auto const y = static_cast<int>((random >> 8) & 15) | 1;
+            auto const z = static_cast<int>((random >> 4) & 15) | 1;
+            solid += is_opaque(section.get(x - 1, y, z)) + is_opaque(section.get(x + 1 == SECTION_SIZE ? x : x + 1, y, z));
+            solid += is_opaque(section.get(x, y - 1, z)) + is_opaque(section.get(x, y + 1 == SECTION_SIZE ? y : y + 1, z));
+            solid += is_opaque(section.get(x, y, z - 1)) + is_opaque(section.get(x, y, z + 1 == SECTION_SIZE ? z : z + 1));
+        }
+    });
+
+    // 16 steps along a random direction in 8.8 fixed point, wrapping around the section
+    constexpr size_t steps {16};
+    auto const walk_ms = bench::time_ms([&] {
+        for (size_t idx{}; idx < ops / steps; ++idx)
+        {
+            auto const random = next();
+            auto const& section = sections[(random >> 24) % sections.size()];
+            uint32_t x {(random & 15) << 8}, y {((random >> 4) & 15) << 8}, z {((random >> 8) & 15) << 8};
+            auto const direction = next();
+            auto const dx = direction & 0x1FF, dy = (direction >> 9) & 0x1FF, dz = (direction >> 18) & 0x1FF;
+            for (size_t step{}; step < steps; ++step)
+            {
+                solid += is_opaque(section.get((x >> 8) & 15, (y >> 8) & 15, (z >> 8) & 15));
+                x += dx;
+                y += dy;
+                z += dz;
+            }
+        }
+    });
+    bench::keep(solid);
+
+    bench::report("chunk", fmt::format("{} random get", name), get_ms * 1e6 / ops, "ns/op");
+    bench::report("chunk", fmt::format("{} 6 neighbours", name), neighbours_ms * 1e6 / (ops / 6), "ns/block");
+    bench::report("chunk", fmt::format("{} random walk", name), walk_ms * 1e6 / ops, "ns/step");
+}
+
+} // namespace
+
+void bench::chunk()
+{
+    memory("flat", bench::flat);
+    memory("hills", bench::hills);
+    memory("scrambled", bench::scrambled);
+    access();
+
+    Chunk chunk{{0, 0}};
+    bench::hills(chunk, 42);
+    layout<LinearLayout>("linear", chunk);
+    layout<MortonLayout>("morton", chunk);
+}
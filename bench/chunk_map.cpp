@@ -0,0 +1,114 @@
+#include <unordered_map>
+#include <vector>
+#include "bench.hpp"
+#include "voxel/chunk_map.hpp"
+
+namespace
+{
+
+constexpr int RADIUS {32};
+constexpr size_t REPEATS {16};
+
+using Baseline = std::unordered_map<ChunkPos, Chunk*>;
+
+std::vector<ChunkPos> random_positions(size_t const count, int const spread)
+{
+    std::vector<ChunkPos> positions;
+    positions.reserve(count);
+    uint32_t state{7};
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        state = state * 1664525u + 1013904223u;
+        auto const x = static_cast<int32_t>((state >> 8) % (2 * spread + 1)) - spread;
+        state = state * 1664525u + 1013904223u;
+        auto const z = static_cast<int32_t>((state >> 8) % (2 * spread + 1)) - spread;
+        positions.push_back({x, z});
+    }
+    return positions;
+}
+
+// Same access pattern as meshing or lighting a chunk: the chunk and its 8 neighbours
+std::vector<ChunkPos> neighbourhoods(ChunkMap const& map)
+{
+    std::vector<ChunkPos> positions;
+    for (auto const* chunk : map)
+    {
+        for (int dz{-1}; dz <= 1; ++dz)
+        {
+            for (int dx{-1}; dx <= 1; ++dx)
+            {
+                positions.push_back({chunk->pos().x + dx, chunk->pos().z + dz});
+            }
+        }
+    }
+    return positions;
+}
+
+template <typename Lookup>
+double ns_per_lookup(std::vector<ChunkPos> const& positions, Lookup&& lookup)
+{
+    size_t found{};
+    auto const elapsed = bench::time_ms([&] {
+        for (size_t repeat{}; repeat < REPEATS; ++repeat)
+        {
+            for (auto const pos : positions)
+            {
+                found += lookup(pos) != nullptr;
+            }
+        }
+    });
+    bench::keep(found);
+    return elapsed * 1e6 / static_cast<double>(positions.size() * REPEATS);
+}
+
+void compare(std::string_view const name, ChunkMap& map, Baseline& baseline, std::vector<ChunkPos> const& positions)
+{
+    auto const flat = ns_per_lookup(positions, [&](ChunkPos const pos) { return map.get(pos); });
+    auto const standard = ns_per_lookup(positions, [&](ChunkPos const pos) -> Chunk* {
+        auto const found_it = baseline.find(pos);
+        return found_it == baseline.end() ? nullptr : found_it->second;
+    });
+    bench::report("chunk_map", fmt::format("{} ChunkMap", name), flat, "ns/lookup");
+    bench::report("chunk_map", fmt::format("{} unordered_map", name), standard, "ns/lookup");
+    bench::report("chunk_map", fmt::format("{} speedup", name), standard / flat, "x");
+}
+
+} // namespace
+
+void bench::chunk_map()
+{
+    ChunkMap map;
+    Baseline baseline;
+    auto const insert_ms = bench::time_ms([&] {
+        for (int z{-RADIUS}; z <= RADIUS; ++z)
+        {
+            for (int x{-RADIUS}; x <= RADIUS; ++x)
+            {
+                map.emplace({x, z});
+            }
+        }
+    });
+    for (auto* chunk : map)
+    {
+        baseline.emplace(chunk->pos(), chunk);
+    }
+    bench::report("chunk_map", "loaded chunks", static_cast<double>(map.size()), "");
+    bench::report("chunk_map", "insert", insert_ms * 1e6 / static_cast<double>(map.size()), "ns/chunk");
+
+    compare("neighbourhood", map, baseline, neighbourhoods(map));
+    compare("random hit", map, baseline, random_positions(1 << 16, RADIUS));
+    compare("random mostly miss", map, baseline, random_positions(1 << 16, RADIUS * 4));
+
+    size_t iterated{};
+    auto const iterate_ms = bench::time_ms([&] {
+        for (size_t repeat{}; repeat < REPEATS; ++repeat)
+        {
+            for (auto const* chunk : map)
+            {
+                iterated += static_cast<size_t>(chunk->pos().x);
+            }
+        }
+    });
+    bench::keep(iterated);
+    bench::report("chunk_map", "iterate", iterate_ms * 1e6 / static_cast<double>(map.size() * REPEATS), "ns/chunk");
+}
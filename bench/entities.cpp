@@ -0,0 +1,94 @@
+#include <vector>
+#include "bench.hpp"
+#include "entities.hpp"
+#include "terrain.hpp"
+
+namespace
+{
+
+constexpr size_t TICKS {100};
+constexpr float TICK_SECONDS {1.f / 480.f};
+constexpr int RADIUS {4};
+
+// Entities flying in straight lines, a tenth of them replaced every tick. Cost per entity should stay flat from
+// a thousand to a million, and with the store reserved up front ticking must not allocate
+void fly(size_t const count)
+{
+    bench::Random random{3};
+    Entities entities{count};
+    std::vector<EntityId> ids;
+    ids.reserve(count);
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        auto const id = ids.emplace_back(entities.spawn({random.next(-64.f, 64.f), random.next(0.f, 128.f), random.next(-64.f, 64.f)}, {0.25f, 0.25f}, 0));
+        entities.velocities.set(entities.index(id), {random.next(-8.f, 8.f), random.next(-8.f, 8.f), random.next(-8.f, 8.f)});
+    }
+
+    auto const allocations = bench::allocations();
+    auto const move_ms = bench::time_ms([&] {
+        for (size_t tick{}; tick < TICKS; ++tick) entities.move(TICK_SECONDS);
+    });
+    bench::keep(entities.positions.x.data());
+
+    auto const churn = count / 10;
+    auto const churn_ms = bench::time_ms([&] {
+        for (size_t tick{}; tick < TICKS; ++tick)
+        {
+            for (size_t idx{}; idx < churn; ++idx)
+            {
+                auto& id = ids[static_cast<size_t>(random.next(0.f, static_cast<float>(count)))];
+                entities.despawn(id);
+                id = entities.spawn({0.f, 64.f, 0.f}, {0.25f, 0.25f}, 0);
+            }
+        }
+    });
+    auto const allocated = bench::allocations() - allocations;
+
+    bench::report("entities", fmt::format("{} flying move", count), move_ms * 1e6 / static_cast<double>(TICKS * count), "ns/entity");
+    bench::report("entities", fmt::format("{} flying respawn", count), churn_ms * 1e6 / static_cast<double>(TICKS * churn), "ns/entity");
+    bench::report("entities", fmt::format("{} flying allocations", count), static_cast<double>(allocated), "per run");
+    bench::check("entities", fmt::format("{} flying without allocating", count), allocated == 0);
+}
+
+// Walkers on generated terrain, everything goes through Physics
+void walk(ChunkMap const& chunks, TerrainGenerator const& terrain, size_t const count)
+{
+    bench::Random random{5};
+    Entities entities{count};
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        glm::vec3 position {random.next(-40.f, 40.f), 0.f, random.next(-40.f, 40.f)};
+        position.y = static_cast<float>(terrain.surface_height(static_cast<int>(position.x), static_cast<int>(position.z)) + 6);
+        auto const id = entities.spawn(position, {0.6f, 1.8f}, Entities::COLLIDES);
+        entities.velocities.set(entities.index(id), {random.next(-4.f, 4.f), 0.f, random.next(-4.f, 4.f)});
+    }
+
+    Physics physics{chunks};
+    // The first tick sizes the physics scratch
+    entities.collide(physics, TICK_SECONDS);
+    auto const allocations = bench::allocations();
+    auto const collide_ms = bench::time_ms([&] {
+        for (size_t tick{}; tick < TICKS; ++tick) entities.collide(physics, TICK_SECONDS);
+    });
+    auto const allocated = bench::allocations() - allocations;
+
+    bench::report("entities", fmt::format("{} walking collide", count), collide_ms * 1e6 / static_cast<double>(TICKS * count), "ns/entity");
+    bench::report("entities", fmt::format("{} walking allocations", count), static_cast<double>(allocated), "per run");
+    bench::check("entities", fmt::format("{} walking without allocating", count), allocated == 0);
+}
+
+} // namespace
+
+void bench::entities()
+{
+    fly(1'000);
+    fly(10'000);
+    fly(100'000);
+    fly(1'000'000);
+
+    ChunkMap chunks;
+    TerrainGenerator const terrain{1337};
+    bench::generate(chunks, terrain, RADIUS);
+    walk(chunks, terrain, 1'000);
+    walk(chunks, terrain, 10'000);
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+#include "bench.hpp"
+#include "triple_buffer.hpp"
+#include "world.hpp"
+
+namespace
+{
+
+constexpr float TICKS_PER_SECOND {480.f};
+constexpr size_t TICKS_PER_FRAME {8};
+constexpr size_t FRAMES {600};
+// Streaming gets this long to load and mesh everything around the player, settled once it stayed idle this many frames
+constexpr auto SETTLE_TIMEOUT {std::chrono::seconds{30}};
+constexpr int SETTLED_FRAMES {60};
+
+// The renderer's side of the handoff without the GPU: takes updates it hasn't seen and keeps the meshes by handle
+struct Mirror
+{
+    std::vector<std::shared_ptr<ChunkMesh const>> meshes;
+    uint64_t sequence{0};
+    size_t updates{0};
+    size_t drawn{0};
+
+    void take(RenderData const& data)
+    {
+        for (auto const& update : data.updates)
+        {
+            if (update.sequence <= sequence) continue;
+            sequence = update.sequence;
+            if (update.handle >= meshes.size()) meshes.resize(update.handle + 1);
+            meshes[update.handle] = update.mesh;
+            ++updates;
+        }
+        for (auto const handle : data.visible)
+        {
+            drawn += meshes[handle]->indices.size();
+        }
+    }
+};
+
+// Settled world, the player standing and looking around. Ticking, filling a snapshot and taking it must not
+// allocate: every container involved was sized by the frames before
+void settled()
+{
+    auto const directory = bench::temp_directory("handoff");
+    std::filesystem::remove_all(directory);
+    {
+        JobSystem jobs{std::max(std::thread::hardware_concurrency(), 2u)};
+        World world{jobs, {1280, 720}, 1.f / TICKS_PER_SECOND, directory};
+        TripleBuffer<RenderData> snapshots{world.to_render()};
+        Mirror mirror;
+        UserInput input;
+        input.mouse_delta = {1.f, 0.f};
+
+        auto const frame = [&] {
+            for (size_t tick{}; tick < TICKS_PER_FRAME; ++tick)
+            {
+                world.tick(input);
+                world.to_render(snapshots.back(), mirror.sequence);
+                snapshots.publish();
+            }
+            snapshots.acquire();
+            mirror.take(snapshots.front());
+        };
+
+        auto const give_up = bench::Clock::now() + SETTLE_TIMEOUT;
+        auto settled_frames = 0;
+        while (settled_frames < SETTLED_FRAMES and bench::Clock::now() < give_up)
+        {
+            frame();
+            auto const& stats = world.streaming_stats();
+            auto const busy = stats.waiting_for_generation + stats.waiting_for_mesh + stats.waiting_for_light + stats.generating + stats.stitching + stats.meshing;
+            settled_frames = busy == 0 ? settled_frames + 1 : 0;
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+
+        auto const updates = mirror.updates;
+        auto const drawn = mirror.drawn;
+        auto const allocations = bench::allocations();
+        auto const ms = bench::time_ms([&] {
+            for (size_t idx{}; idx < FRAMES; ++idx) frame();
+        });
+        auto const allocated = bench::allocations() - allocations;
+
+        bench::report("handoff", "meshed chunks", world.streaming_stats().meshed, "chunks");
+        bench::report("handoff", "visible chunks", static_cast<double>(snapshots.front().visible.size()), "chunks");
+        bench::report("handoff", "indices drawn per frame", static_cast<double>(mirror.drawn - drawn) / FRAMES, "indices");
+        bench::report("handoff", "updates while settled", static_cast<double>(mirror.updates - updates), "updates");
+        bench::report("handoff", "frame, 8 ticks and a snapshot each", ms * 1e3 / FRAMES, "us");
+        bench::report("handoff", "allocations while settled", static_cast<double>(allocated), "per run");
+        // Measured anyway when streaming never settled, but chunks still loading allocate and the numbers mean little
+        bench::check("handoff", "settling within the timeout", settled_frames >= SETTLED_FRAMES);
+        bench::check("handoff", "no allocations while settled", allocated == 0);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace
+
+void bench::handoff()
+{
+    settled();
+}
@@ -0,0 +1,42 @@
+#include "bench.hpp"
+#include "input.hpp"
+
+namespace
+{
+
+constexpr size_t FRAMES {1 << 14};
+
+// What the game does with input every frame: held keys move on, mouse movement comes in, actions are refilled
+void frames(std::string_view const name, std::initializer_list<int> const held)
+{
+    InputCollector collector{nullptr};
+    for (auto const key : held) collector.key_event(key, GLFW_PRESS);
+
+    UserInput input;
+    float x{};
+    auto const run = [&] {
+        for (size_t frame{}; frame < FRAMES; ++frame)
+        {
+            collector.mouse_event({x += 1.f, 0.f});
+            collector.update();
+            collector.actions(input);
+            bench::keep(input.user_actions.data());
+        }
+    };
+    auto const summary = bench::repeat(run, [](double const ms) { return ms * 1e6 / FRAMES; });
+
+    auto const allocations = bench::allocations();
+    run();
+    auto const allocated = bench::allocations() - allocations;
+
+    bench::report("input", fmt::format("{} actions", name), summary, "ns/frame");
+    bench::report("input", fmt::format("{} allocations", name), static_cast<double>(allocated), "per run");
+}
+
+} // namespace
+
+void bench::input()
+{
+    frames("no keys", {});
+    frames("3 keys held", {GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_SPACE});
+}
@@ -0,0 +1,94 @@
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+#include "bench.hpp"
+#include "jobs.hpp"
+#include "terrain.hpp"
+#include "voxel/mesher.hpp"
+
+namespace
+{
+
+constexpr int RADIUS {8};
+constexpr std::array<size_t, 5> THREAD_COUNTS {1, 2, 4, 8, 16};
+
+struct Timings
+{
+    double generate_ms;
+    double mesh_ms;
+};
+
+// Same shape of work as loading a world: generate every chunk, then mesh the ones with all neighbours loaded
+Timings load_world(size_t const thread_count)
+{
+    JobSystem jobs{thread_count};
+    ChunkMap chunks;
+    std::vector<Chunk*> generated;
+    for (int z{-RADIUS}; z <= RADIUS; ++z)
+    {
+        for (int x{-RADIUS}; x <= RADIUS; ++x)
+        {
+            generated.push_back(chunks.get(chunks.emplace({x, z})));
+        }
+    }
+
+    auto const generate_ms = bench::time_ms([&] {
+        jobs.parallel_for(generated.size(), [&](size_t const idx) {
+            auto& chunk = *generated[idx];
+            bench::caves(chunk, static_cast<uint32_t>(chunk.pos().x * 7919 + chunk.pos().z));
+            chunk.compact();
+        });
+    });
+
+    std::vector<Chunk const*> inner;
+    for (auto const* chunk : generated)
+    {
+        if (std::abs(chunk->pos().x) < RADIUS and std::abs(chunk->pos().z) < RADIUS) inner.push_back(chunk);
+    }
+    std::vector<ChunkMesher> meshers(jobs.thread_count());
+    std::vector<ChunkMesh> meshes(inner.size());
+    auto const mesh_ms = bench::time_ms([&] {
+        jobs.parallel_for(inner.size(), [&](size_t const idx) {
+            meshers[jobs.thread_index()].mesh(chunks, *inner[idx], meshes[idx]);
+        });
+    });
+    bench::keep(meshes);
+    return {generate_ms, mesh_ms};
+}
+
+// Cost of the system itself, jobs that do nothing
+double ns_per_empty_job(size_t const thread_count)
+{
+    constexpr size_t count {1 << 18};
+    JobSystem jobs{thread_count};
+    std::atomic<size_t> ran{0};
+    auto const elapsed = bench::time_ms([&] {
+        jobs.parallel_for(count, [&](size_t) { ran.fetch_add(1, std::memory_order_relaxed); });
+    });
+    bench::keep(ran);
+    return elapsed * 1e6 / count;
+}
+
+} // namespace
+
+void bench::jobs()
+{
+    bench::report("jobs", "hardware threads", std::thread::hardware_concurrency(), "");
+
+    Timings baseline{};
+    for (auto const thread_count : THREAD_COUNTS)
+    {
+        auto const timings = load_world(thread_count);
+        if (thread_count == 1) baseline = timings;
+        auto const total = timings.generate_ms + timings.mesh_ms;
+        bench::report("jobs", fmt::format("generate {} threads", thread_count), timings.generate_ms, "ms");
+        bench::report("jobs", fmt::format("mesh {} threads", thread_count), timings.mesh_ms, "ms");
+        bench::report("jobs", fmt::format("speedup {} threads", thread_count), (baseline.generate_ms + baseline.mesh_ms) / total, "x");
+    }
+
+    for (auto const thread_count : THREAD_COUNTS)
+    {
+        bench::report("jobs", fmt::format("empty job {} threads", thread_count), ns_per_empty_job(thread_count), "ns/job");
+    }
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <vector>
+#include "bench.hpp"
+#include "terrain.hpp"
+#include "voxel/light.hpp"
+#include "voxel/mesher.hpp"
+
+namespace
+{
+
+constexpr int RADIUS {2};
+constexpr size_t EDITS {2000};
+
+// The way the streamer lights chunks, each on its own first, then stitched together
+void light_all(ChunkMap& chunks, LightEngine& engine, double* light_ms = nullptr, double* stitch_ms = nullptr)
+{
+    auto const lit = bench::time_ms([&] {
+        for (auto* chunk : chunks) engine.light_chunk(*chunk);
+    });
+    auto const stitched = bench::time_ms([&] {
+        for (auto const* chunk : chunks) engine.stitch(LightEngine::area(chunks, chunk->pos()));
+    });
+    if (light_ms != nullptr) *light_ms = lit;
+    if (stitch_ms != nullptr) *stitch_ms = stitched;
+    engine.clear_touched();
+}
+
+struct Edit
+{
+    glm::ivec3 position;
+    Block block;
+};
+
+void set(ChunkMap& chunks, Edit const& edit)
+{
+    chunks.get(ChunkPos{edit.position.x >> 4, edit.position.z >> 4})->set(edit.position.x & 15, edit.position.y, edit.position.z & 15, edit.block);
+}
+
+// Edits anywhere in the middle 3 x 3 chunks, so their light reaches into the outer ring too
+std::vector<Edit> edits(TerrainGenerator const& terrain, Block const block, int const min_depth, int const max_depth, uint32_t const seed)
+{
+    bench::Random random{seed};
+    std::vector<Edit> result;
+    for (size_t idx{}; idx < EDITS; ++idx)
+    {
+        auto const x = random.next(3 * SECTION_SIZE) - SECTION_SIZE;
+        auto const z = random.next(3 * SECTION_SIZE) - SECTION_SIZE;
+        auto const y = terrain.surface_height(x, z) - min_depth - random.next(max_depth - min_depth + 1);
+        result.push_back({{x, y, z}, block});
+    }
+    return result;
+}
+
+void measure(std::string_view const name, ChunkMap& chunks, LightEngine& engine, std::vector<Edit> const& planned, std::vector<Edit>& applied)
+{
+    std::vector<double> times;
+    double total_ms{};
+    for (auto const& edit : planned)
+    {
+        auto const elapsed = bench::time_ms([&] {
+            set(chunks, edit);
+            auto const area = LightEngine::area(chunks, ChunkPos{edit.position.x >> 4, edit.position.z >> 4});
+            engine.block_changed(area, edit.position.x & 15, edit.position.y, edit.position.z & 15);
+        });
+        total_ms += elapsed;
+        times.push_back(elapsed);
+        applied.push_back(edit);
+    }
+    engine.clear_touched();
+
+    // Worst alone is mostly whoever got preempted, p99 says more about big relights
+    std::ranges::sort(times);
+    bench::report("light", fmt::format("{} mean", name), total_ms * 1e3 / static_cast<double>(times.size()), "us/edit");
+    bench::report("light", fmt::format("{} p99", name), times[times.size() * 99 / 100] * 1e3, "us/edit");
+    bench::report("light", fmt::format("{} worst", name), times.back() * 1e3, "us/edit");
+}
+
+uint32_t vertices(ChunkMap const& chunks)
+{
+    ChunkMesher mesher;
+    ChunkMesh mesh;
+    return mesher.mesh(chunks, *chunks.get(ChunkPos{0, 0}), mesh).vertices;
+}
+
+} // namespace
+
+void bench::light()
+{
+    TerrainGenerator const terrain{1337};
+    ChunkMap chunks;
+    bench::generate(chunks, terrain, RADIUS);
+    auto const unlit_vertices = vertices(chunks);
+
+    LightEngine engine;
+    double light_ms{};
+    double stitch_ms{};
+    light_all(chunks, engine, &light_ms, &stitch_ms);
+    auto const count = static_cast<double>(chunks.size());
+    bench::report("light", "light chunk", light_ms / count, "ms/chunk");
+    bench::report("light", "stitch chunk", stitch_ms * 1e3 / count, "us/chunk");
+    bench::report("light", "vertices unlit", unlit_vertices, "per chunk");
+    bench::report("light", "vertices lit", vertices(chunks), "per chunk");
+
+    // Roofs cast shadows, digging lets sky light in, lamps light up the ground and the caves
+    std::vector<Edit> applied;
+    measure("place above ground", chunks, engine, edits(terrain, Block::Stone, -8, -2, 1), applied);
+    measure("dig", chunks, engine, edits(terrain, Block::Air, 0, 12, 2), applied);
+    measure("place lamp", chunks, engine, edits(terrain, Block::Lamp, -2, 20, 3), applied);
+    measure("break lamp", chunks, engine, edits(terrain, Block::Air, -2, 20, 3), applied);
+    measure("break roof", chunks, engine, edits(terrain, Block::Air, -8, -2, 1), applied);
+
+    // Incremental updates have to end up where lighting the edited world from scratch does
+    ChunkMap fresh;
+    bench::generate(fresh, terrain, RADIUS);
+    for (auto const& edit : applied) set(fresh, edit);
+    LightEngine fresh_engine;
+    light_all(fresh, fresh_engine);
+
+    size_t different{};
+    for (auto* chunk : chunks)
+    {
+        auto const expected = fresh.get(chunk->pos())->light_data();
+        auto const actual = chunk->light_data();
+        for (size_t idx{}; idx < expected.size(); ++idx)
+        {
+            different += expected[idx] != actual[idx];
+        }
+    }
+    bench::report("light", "mismatches against relighting", static_cast<double>(different), "blocks");
+    bench::check("light", "incremental updates matching relighting", different == 0);
+}
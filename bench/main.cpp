@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <vector>
+#include "bench.hpp"
+
+namespace
+{
+
+struct Suite
+{
+    std::string_view name;
+    void (*run)();
+};
+
+constexpr std::array suites {
+    Suite{"camera", bench::camera},
+    Suite{"chunk", bench::chunk},
+    Suite{"chunk_map", bench::chunk_map},
+    Suite{"entities", bench::entities},
+    Suite{"handoff", bench::handoff},
+    Suite{"input", bench::input},
+    Suite{"jobs", bench::jobs},
+    Suite{"light", bench::light},
+    Suite{"mesher", bench::mesher},
+    Suite{"noise", bench::noise},
+    Suite{"physics", bench::physics},
+    Suite{"raycast", bench::raycast},
+    Suite{"region", bench::region},
+    Suite{"streaming", bench::streaming},
+    Suite{"writeback", bench::writeback},
+};
+
+} // namespace
+
+// Usage: bench [--json] [suite...], runs everything when no suite is given. --json prints one object per result.
+// Exits with 1 when a check of any suite failed
+int main(int argc, char* argv[])
+{
+#ifdef __BMI2__
+    // bench_morton_bmi2 can't run everywhere, 77 has meson skip it
+    if (not __builtin_cpu_supports("bmi2"))
+    {
+        fmt::print(stderr, "bench: built for BMI2, which this CPU doesn't have\n");
+        return 77;
+    }
+#endif
+    std::vector<std::string_view> selection;
+    for (int idx{1}; idx < argc; ++idx)
+    {
+        std::string_view const arg {argv[idx]};
+        if (arg == "--json")
+        {
+            bench::set_output(bench::Output::Json);
+            continue;
+        }
+        if (std::none_of(suites.begin(), suites.end(), [&](Suite const& suite) { return suite.name == arg; }))
+        {
+            fmt::print(stderr, "bench: unknown suite {}\n", arg);
+            return 1;
+        }
+        selection.push_back(arg);
+    }
+
+    for (auto const& suite : suites)
+    {
+        if (selection.empty() or std::find(selection.begin(), selection.end(), suite.name) != selection.end()) suite.run();
+    }
+    return bench::failed() ? 1 : 0;
+}
@@ -0,0 +1,64 @@
+#include "bench.hpp"
+#include "terrain.hpp"
+#include "voxel/mesher.hpp"
+
+namespace
+{
+
+constexpr int RADIUS {2};
+constexpr size_t REPEATS {8};
+
+void run(std::string_view const name, void (*generate)(Chunk&, uint32_t))
+{
+    ChunkMap chunks;
+    for (int z{-RADIUS}; z <= RADIUS; ++z)
+    {
+        for (int x{-RADIUS}; x <= RADIUS; ++x)
+        {
+            auto& chunk = *chunks.get(chunks.emplace({x, z}));
+            generate(chunk, static_cast<uint32_t>(x * 7919 + z));
+            chunk.compact();
+        }
+    }
+
+    // Only the inner chunks have all of their neighbours loaded
+    ChunkMesher mesher;
+    ChunkMesh mesh;
+    MeshStats total{};
+    size_t meshed{};
+    constexpr auto inner = static_cast<double>((2 * RADIUS - 1) * (2 * RADIUS - 1));
+    auto const time = bench::repeat([&] {
+        for (auto const* chunk : chunks)
+        {
+            if (std::abs(chunk->pos().x) == RADIUS or std::abs(chunk->pos().z) == RADIUS) continue;
+            auto const stats = mesher.mesh(chunks, *chunk, mesh);
+            total.faces += stats.faces;
+            total.quads += stats.quads;
+            total.vertices += stats.vertices;
+            total.copy_milliseconds += stats.copy_milliseconds;
+            total.cull_milliseconds += stats.cull_milliseconds;
+            total.milliseconds += stats.milliseconds;
+            ++meshed;
+        }
+    }, [](double const ms) { return ms / inner; }, {.warmup = 1, .runs = REPEATS});
+
+    auto const count = static_cast<double>(meshed);
+    bench::report("mesher", fmt::format("{} time", name), time, "ms/chunk");
+    bench::report("mesher", fmt::format("{} neighbourhood copy", name), total.copy_milliseconds / count, "ms/chunk");
+    bench::report("mesher", fmt::format("{} culling", name), total.cull_milliseconds / count, "ms/chunk");
+    bench::report("mesher", fmt::format("{} vertices", name), total.vertices / count, "vertices/chunk");
+    bench::report("mesher", fmt::format("{} unmerged vertices", name), total.faces * 4 / count, "vertices/chunk");
+    bench::report("mesher", fmt::format("{} reduction", name), static_cast<double>(total.faces * 4) / std::max(total.vertices, 1u), "x");
+    bench::report("mesher", fmt::format("{} vertex memory", name), total.vertices * sizeof(PackedVertex) / count / 1024, "KiB/chunk");
+    bench::report("mesher", fmt::format("{} unpacked vertex memory", name), total.vertices * sizeof(Vertex) / count / 1024, "KiB/chunk");
+}
+
+} // namespace
+
+void bench::mesher()
+{
+    run("flat", bench::flat);
+    run("hills", bench::hills);
+    run("caves", bench::caves);
+    run("checkerboard", bench::checkerboard);
+}
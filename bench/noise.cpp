@@ -0,0 +1,121 @@
+#include <bit>
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "worldgen/noise.hpp"
+#include "worldgen/terrain.hpp"
+
+namespace
+{
+
+constexpr NoiseSettings FRACTAL {.seed = 42, .frequency = 1.f / 64.f, .octaves = 4};
+constexpr size_t REPEATS {256};
+
+constexpr std::string_view name(SimdLevel const level)
+{
+    switch (level)
+    {
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Sse2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+std::vector<SimdLevel> available_levels()
+{
+    std::vector<SimdLevel> levels;
+    for (auto level = SimdLevel::Scalar; level <= detect_simd_level(); level = static_cast<SimdLevel>(static_cast<uint8_t>(level) + 1))
+    {
+        levels.push_back(level);
+    }
+    return levels;
+}
+
+// Single thread, so this is also samples per second per core
+void throughput(SimdLevel const level)
+{
+    Noise const noise{FRACTAL, level};
+    std::vector<float> out(SECTION_VOLUME);
+
+    constexpr auto samples_2d = static_cast<double>(REPEATS * SECTION_SIZE * SECTION_SIZE);
+    constexpr auto samples_3d = static_cast<double>(REPEATS * SECTION_VOLUME);
+    auto const heightmap = bench::repeat([&] {
+        for (size_t repeat{}; repeat < REPEATS; ++repeat)
+        {
+            noise.fill_2d({static_cast<float>(repeat * SECTION_SIZE), 0.f}, 1.f, {SECTION_SIZE, SECTION_SIZE}, out);
+            bench::keep(out);
+        }
+    }, [](double const ms) { return samples_2d / ms / 1e3; });
+    auto const section = bench::repeat([&] {
+        for (size_t repeat{}; repeat < REPEATS; ++repeat)
+        {
+            noise.fill_3d({static_cast<float>(repeat * SECTION_SIZE), 0.f, 0.f}, 1.f, {SECTION_SIZE, SECTION_SIZE, SECTION_SIZE}, out);
+            bench::keep(out);
+        }
+    }, [](double const ms) { return samples_3d / ms / 1e3; });
+
+    bench::report("noise", fmt::format("{} 2D fBm x{}", name(level), FRACTAL.octaves), heightmap, "Msamples/s");
+    bench::report("noise", fmt::format("{} 3D fBm x{}", name(level), FRACTAL.octaves), section, "Msamples/s");
+}
+
+// Every level has to give bit identical results, odd sizes cover partial vectors and negative
+// coordinates the floor emulation of SSE2
+size_t mismatches(SimdLevel const level)
+{
+    constexpr glm::ivec3 size {13, 7, 5};
+    constexpr glm::vec3 origin {-37.25f, -3.5f, 1000.75f};
+    constexpr auto volume = static_cast<size_t>(size.x * size.y * size.z);
+
+    Noise const reference{FRACTAL, SimdLevel::Scalar};
+    Noise const noise{FRACTAL, level};
+    std::vector<float> expected(volume), actual(volume);
+
+    size_t different{};
+    auto const compare = [&] {
+        for (size_t idx{}; idx < volume; ++idx)
+        {
+            different += std::bit_cast<uint32_t>(expected[idx]) != std::bit_cast<uint32_t>(actual[idx]);
+        }
+    };
+
+    reference.fill_3d(origin, 0.37f, size, expected);
+    noise.fill_3d(origin, 0.37f, size, actual);
+    compare();
+    reference.fill_2d({origin.x, origin.z}, 0.37f, {size.x, size.y}, expected);
+    noise.fill_2d({origin.x, origin.z}, 0.37f, {size.x, size.y}, actual);
+    compare();
+    return different;
+}
+
+void terrain()
+{
+    constexpr size_t count {256};
+    TerrainGenerator const generator{1337};
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    chunks.reserve(count);
+    auto const elapsed = bench::time_ms([&] {
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            auto& chunk = chunks.emplace_back(std::make_unique<Chunk>(ChunkPos{static_cast<int32_t>(idx % 16), static_cast<int32_t>(idx / 16)}));
+            generator.generate(*chunk);
+        }
+    });
+    bench::report("noise", "terrain generation", elapsed / count, "ms/chunk");
+}
+
+} // namespace
+
+void bench::noise()
+{
+    for (auto const level : available_levels())
+    {
+        throughput(level);
+    }
+    for (auto const level : available_levels())
+    {
+        auto const different = mismatches(level);
+        bench::report("noise", fmt::format("{} vs scalar mismatches", name(level)), static_cast<double>(different), "samples");
+        bench::check("noise", fmt::format("{} matching the scalar reference", name(level)), different == 0);
+    }
+    terrain();
+}
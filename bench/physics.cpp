@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "bench.hpp"
+#include "terrain.hpp"
+#include "voxel/physics.hpp"
+
+namespace
+{
+
+constexpr int RADIUS {4};
+// A second of ticks at 60 frames and 8 ticks per frame
+constexpr size_t TICKS {480};
+constexpr float TICK_SECONDS {1.f / TICKS};
+
+// Bodies overlapping an opaque block, physics should never let that happen
+size_t stuck(ChunkMap const& chunks, std::vector<Body> const& bodies)
+{
+    size_t count{};
+    for (auto const& body : bodies)
+    {
+        auto const half_width = body.size.x / 2.f - 1e-3f;
+        glm::ivec3 const from {glm::floor(body.position - glm::vec3{half_width, -1e-3f, half_width})};
+        glm::ivec3 const to {glm::floor(body.position + glm::vec3{half_width, body.size.y - 1e-3f, half_width})};
+        auto inside = false;
+        for (int y{from.y}; y <= to.y; ++y)
+        {
+            for (int z{from.z}; z <= to.z; ++z)
+            {
+                for (int x{from.x}; x <= to.x; ++x)
+                {
+                    auto const* chunk = chunks.get(ChunkPos{x >> 4, z >> 4});
+                    inside = inside or (chunk != nullptr and is_opaque(chunk->get(x & (SECTION_SIZE - 1), y, z & (SECTION_SIZE - 1))));
+                }
+            }
+        }
+        count += inside;
+    }
+    return count;
+}
+
+// Bodies dropped onto the terrain near the middle, walking in random directions and jumping now and then
+void walk(ChunkMap const& chunks, TerrainGenerator const& terrain, size_t const count)
+{
+    bench::Random random{11};
+    constexpr float SPAN {(RADIUS - 1) * SECTION_SIZE};
+    std::vector<Body> bodies(count);
+    for (auto& body : bodies)
+    {
+        body.position = {random.next(-SPAN, SPAN), 0.f, random.next(-SPAN, SPAN)};
+        // Above the highest column the body covers
+        int surface{};
+        for (auto const dx : {-0.3f, 0.3f})
+        {
+            for (auto const dz : {-0.3f, 0.3f})
+            {
+                auto const x = static_cast<int>(std::floor(body.position.x + dx));
+                auto const z = static_cast<int>(std::floor(body.position.z + dz));
+                surface = std::max(surface, terrain.surface_height(x, z));
+            }
+        }
+        body.position.y = static_cast<float>(surface + 2);
+    }
+
+    Physics physics{chunks};
+    double total_ms{};
+    double worst_ms{};
+    for (size_t tick{}; tick < TICKS; ++tick)
+    {
+        for (auto& body : bodies)
+        {
+            if (tick % 120 == 0) body.velocity = {random.next(-4.3f, 4.3f), body.velocity.y, random.next(-4.3f, 4.3f)};
+            if (body.on_ground and random.next(0.f, 1.f) < 0.01f) body.velocity.y = 8.4f;
+        }
+        auto const elapsed = bench::time_ms([&] { physics.step(bodies, TICK_SECONDS); });
+        total_ms += elapsed;
+        worst_ms = std::max(worst_ms, elapsed);
+    }
+
+    size_t grounded{};
+    for (auto const& body : bodies) grounded += body.on_ground;
+
+    bench::report("physics", fmt::format("{} bodies tick mean", count), total_ms * 1e3 / TICKS, "us");
+    bench::report("physics", fmt::format("{} bodies tick worst", count), worst_ms * 1e3, "us");
+    bench::report("physics", fmt::format("{} bodies per body", count), total_ms * 1e6 / (TICKS * count), "ns/tick");
+    bench::report("physics", fmt::format("{} bodies on ground", count), static_cast<double>(grounded) * 100. / count, "%");
+    auto const stuck_count = stuck(chunks, bodies);
+    bench::report("physics", fmt::format("{} bodies stuck in blocks", count), static_cast<double>(stuck_count), "bodies");
+    bench::check("physics", fmt::format("{} bodies never stuck in blocks", count), stuck_count == 0);
+}
+
+} // namespace
+
+void bench::physics()
+{
+    ChunkMap chunks;
+    TerrainGenerator const terrain{1337};
+    bench::generate(chunks, terrain, RADIUS);
+
+    walk(chunks, terrain, 1);
+    walk(chunks, terrain, 100);
+    walk(chunks, terrain, 10'000);
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "bench.hpp"
+#include "terrain.hpp"
+#include "voxel/raycast.hpp"
+
+namespace
+{
+
+constexpr int RADIUS {4};
+constexpr size_t RAYS {1 << 18};
+constexpr float REACH {96.f};
+// Rays of each set also cast by the reference, it walks every block and takes a while
+constexpr size_t CHECKED_RAYS {4096};
+
+// Rays start at from_y to to_y over the middle chunks, to_target aims them at points on the same heights
+// elsewhere, like line of sight checks between players
+std::vector<Ray> rays(float const from_y, float const to_y, bool const to_target)
+{
+    bench::Random random{7};
+    constexpr float SPAN {RADIUS * SECTION_SIZE};
+    std::vector<Ray> result(RAYS);
+    for (auto& ray : result)
+    {
+        ray.origin = {random.next(-SPAN / 2, SPAN / 2), random.next(from_y, to_y), random.next(-SPAN / 2, SPAN / 2)};
+        if (to_target)
+        {
+            glm::vec3 const target {random.next(-SPAN, SPAN), random.next(from_y, to_y), random.next(-SPAN, SPAN)};
+            ray.direction = target - ray.origin;
+            ray.max_distance = glm::length(ray.direction);
+            if (ray.max_distance == 0.f) ray.direction = {0.f, 1.f, 0.f};
+        }
+        else
+        {
+            ray.direction = {random.next(-1.f, 1.f), random.next(-1.f, 1.f), random.next(-1.f, 1.f)};
+            if (glm::length(ray.direction) == 0.f) ray.direction = {0.f, 1.f, 0.f};
+            ray.max_distance = REACH;
+        }
+    }
+    return result;
+}
+
+// The same walk as Raycaster, block by block through every cell with nothing skipped. Slow, but simple enough to
+// trust, and where the raycaster skips empty boxes is what it checks
+std::optional<RayHit> reference(ChunkMap const& chunks, Ray const& ray)
+{
+    auto const direction = ray.direction / glm::length(ray.direction);
+    glm::ivec3 cell {glm::floor(ray.origin)};
+    glm::ivec3 step{};
+    glm::vec3 t_delta{std::numeric_limits<float>::infinity()};
+    glm::vec3 t_max{std::numeric_limits<float>::infinity()};
+    for (int axis{}; axis < 3; ++axis)
+    {
+        if (direction[axis] == 0.f) continue;
+        step[axis] = direction[axis] > 0.f ? 1 : -1;
+        t_delta[axis] = std::abs(1.f / direction[axis]);
+        auto const line = static_cast<float>(step[axis] > 0 ? cell[axis] + 1 : cell[axis]);
+        t_max[axis] = (line - ray.origin[axis]) / direction[axis];
+    }
+
+    auto const magnitude = glm::abs(direction);
+    int entered {magnitude.x >= magnitude.y ? (magnitude.x >= magnitude.z ? 0 : 2) : (magnitude.y >= magnitude.z ? 1 : 2)};
+    float distance {0.f};
+    while (distance <= ray.max_distance)
+    {
+        auto const* chunk = chunks.get(ChunkPos{cell.x >> 4, cell.z >> 4});
+        if (chunk != nullptr and cell.y >= 0 and cell.y < CHUNK_HEIGHT)
+        {
+            auto const block = chunk->get(cell.x & (SECTION_SIZE - 1), cell.y, cell.z & (SECTION_SIZE - 1));
+            if (is_opaque(block))
+            {
+                auto const face = static_cast<Face>(entered * 2 + (step[entered] > 0 ? 1 : 0));
+                return RayHit{cell, block, face, distance};
+            }
+        }
+        auto const axis = t_max.x < t_max.y ? (t_max.x < t_max.z ? 0 : 2) : (t_max.y < t_max.z ? 1 : 2);
+        distance = t_max[axis];
+        cell[axis] += step[axis];
+        t_max[axis] += t_delta[axis];
+        entered = axis;
+    }
+    return std::nullopt;
+}
+
+// Distances only up to rounding, after a skip the raycaster measures from the origin again instead of adding up steps
+bool same(std::optional<RayHit> const& hit, std::optional<RayHit> const& expected)
+{
+    if (hit.has_value() != expected.has_value()) return false;
+    if (not hit) return true;
+    return hit->position == expected->position and hit->block == expected->block and hit->face == expected->face
+        and std::abs(hit->distance - expected->distance) <= 1e-3f * std::max(1.f, expected->distance);
+}
+
+void run(std::string_view const name, ChunkMap const& chunks, std::vector<Ray> const& rays)
+{
+    Raycaster caster{chunks};
+    auto const per_second = [&](double const ms) { return static_cast<double>(rays.size()) / ms * 1e-3; };
+    size_t hit_count{};
+    auto const single = bench::repeat([&] {
+        hit_count = 0;
+        for (auto const& ray : rays)
+        {
+            hit_count += caster.cast(ray).has_value();
+        }
+    }, per_second, {.warmup = 1, .runs = 5});
+
+    std::vector<std::optional<RayHit>> hits(rays.size());
+    auto const batch = bench::repeat([&] {
+        caster.cast(rays, hits);
+        bench::keep(hits);
+    }, per_second, {.warmup = 1, .runs = 5});
+
+    bench::report("raycast", fmt::format("{} one by one", name), single, "M rays/s");
+    bench::report("raycast", fmt::format("{} batched", name), batch, "M rays/s");
+    bench::report("raycast", fmt::format("{} hit", name), static_cast<double>(hit_count) * 100. / static_cast<double>(rays.size()), "%");
+
+    size_t different{};
+    for (size_t idx{}; idx < std::min(CHECKED_RAYS, rays.size()); ++idx)
+    {
+        different += not same(hits[idx], reference(chunks, rays[idx]));
+    }
+    bench::check("raycast", fmt::format("{} same as the reference", name), different == 0);
+}
+
+} // namespace
+
+void bench::raycast()
+{
+    ChunkMap chunks;
+    TerrainGenerator const terrain{1337};
+    bench::generate(chunks, terrain, RADIUS);
+    auto const surface = static_cast<float>(terrain.surface_height(0, 0));
+
+    // Dense: from inside the ground and caves, most rays end within a few blocks
+    run("underground", chunks, rays(8.f, surface - 8.f, false));
+    // Picking from around eye height, about half the rays go up into the sky
+    run("surface", chunks, rays(surface + 1.f, surface + 3.f, false));
+    // Sparse: high above the terrain, mostly empty sections and open sky
+    run("sky", chunks, rays(surface + 40.f, static_cast<float>(CHUNK_HEIGHT), false));
+    run("line of sight", chunks, rays(surface + 2.f, surface + 20.f, true));
+}
@@ -0,0 +1,123 @@
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "jobs.hpp"
+#include "persist/chunk_codec.hpp"
+#include "persist/lz.hpp"
+#include "persist/storage.hpp"
+#include "worldgen/terrain.hpp"
+
+namespace
+{
+
+// 100 x 100 chunks, about ten thousand, spread over 16 region files
+constexpr int WORLD_SIZE {100};
+
+std::vector<std::unique_ptr<Chunk>> generate_world()
+{
+    JobSystem jobs;
+    TerrainGenerator const terrain{1337};
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    for (int z{}; z < WORLD_SIZE; ++z)
+    {
+        for (int x{}; x < WORLD_SIZE; ++x)
+        {
+            chunks.push_back(std::make_unique<Chunk>(ChunkPos{x - WORLD_SIZE / 2, z - WORLD_SIZE / 2}));
+        }
+    }
+    jobs.parallel_for(chunks.size(), [&](size_t const idx) { terrain.generate(*chunks[idx]); });
+    return chunks;
+}
+
+} // namespace
+
+void bench::region()
+{
+    auto const directory = bench::temp_directory("regions");
+    std::filesystem::remove_all(directory);
+    auto const world = generate_world();
+    auto const count = static_cast<double>(world.size());
+
+    size_t encoded_bytes{};
+    size_t compressed_bytes{};
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> compressed;
+    for (auto const& chunk : world)
+    {
+        encoded.clear();
+        compressed.clear();
+        encode_chunk(*chunk, encoded);
+        lz::compress(encoded, compressed);
+        encoded_bytes += encoded.size();
+        compressed_bytes += compressed.size();
+    }
+
+    size_t disk_bytes{};
+    {
+        RegionStorage storage{directory};
+        auto const save_ms = bench::time_ms([&] {
+            for (auto const& chunk : world)
+            {
+                storage.save(*chunk);
+            }
+        });
+        auto const flush_ms = bench::time_ms([&] { storage.flush(); });
+        disk_bytes = storage.disk_usage();
+
+        bench::report("region", "chunks", count, "");
+        bench::report("region", "save", count / save_ms * 1e3, "chunks/s");
+        bench::report("region", "save", static_cast<double>(encoded_bytes) / save_ms / 1e3, "MB/s uncompressed");
+        bench::report("region", "flush", flush_ms, "ms");
+        bench::report("region", "on disk", static_cast<double>(disk_bytes) / count, "B/chunk");
+        bench::report("region", "encoded", static_cast<double>(encoded_bytes) / count, "B/chunk");
+        bench::report("region", "compression", static_cast<double>(encoded_bytes) / static_cast<double>(compressed_bytes), "x");
+        bench::report("region", "compression", static_cast<double>(encoded_bytes) / static_cast<double>(disk_bytes), "x incl. sector padding");
+    }
+
+    // Fresh storage, so files are opened and mapped again like when a saved world is loaded
+    RegionStorage storage{directory};
+    std::vector<std::unique_ptr<Chunk>> loaded;
+    loaded.reserve(world.size());
+    size_t failed{};
+    auto const load_ms = bench::time_ms([&] {
+        for (auto const& chunk : world)
+        {
+            auto& copy = loaded.emplace_back(std::make_unique<Chunk>(chunk->pos()));
+            failed += not storage.load(*copy);
+        }
+    });
+    bench::report("region", "load", count / load_ms * 1e3, "chunks/s");
+    bench::report("region", "load", static_cast<double>(encoded_bytes) / load_ms / 1e3, "MB/s uncompressed");
+
+    // Round trip has to give back the exact same sections
+    size_t different{};
+    std::vector<uint8_t> original;
+    for (size_t idx{}; idx < world.size(); ++idx)
+    {
+        original.clear();
+        encoded.clear();
+        encode_chunk(*world[idx], original);
+        encode_chunk(*loaded[idx], encoded);
+        different += original != encoded;
+    }
+    bench::report("region", "failed loads", static_cast<double>(failed), "chunks");
+    bench::report("region", "round trip mismatches", static_cast<double>(different), "chunks");
+    bench::check("region", "round trip", failed == 0 and different == 0);
+
+    // Saving the world again twice, flushed in between. The second time fits into the sectors the first one freed
+    auto const resave = [&] {
+        for (auto const& chunk : world)
+        {
+            storage.save(*chunk);
+        }
+        storage.flush();
+        return storage.disk_usage();
+    };
+    auto const first_resave = resave();
+    auto const second_resave = resave();
+    bench::report("region", "on disk after resaving", static_cast<double>(second_resave) / count, "B/chunk");
+    bench::check("region", "resaving reuses freed sectors", second_resave <= first_resave);
+
+    std::filesystem::remove_all(directory);
+}
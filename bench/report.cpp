@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include "bench.hpp"
+#include "voxel/chunk.hpp"
+
+namespace
+{
+
+bench::Output output {bench::Output::Text};
+bool any_failed {false};
+
+} // namespace
+
+bench::Summary bench::summarize(std::vector<double> values)
+{
+    if (values.empty()) return {};
+    std::sort(values.begin(), values.end());
+    auto const count = values.size();
+    auto const middle = count / 2;
+    auto const median = count % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2.;
+    auto const mean = std::accumulate(values.begin(), values.end(), 0.) / static_cast<double>(count);
+    double squares{};
+    for (auto const value : values) squares += (value - mean) * (value - mean);
+    // Sample standard deviation, the runs are a sample of all the runs there could be
+    auto const stddev = count > 1 ? std::sqrt(squares / static_cast<double>(count - 1)) : 0.;
+    return {median, mean, stddev, values.front(), values.back(), count};
+}
+
+void bench::set_output(Output const format)
+{
+    output = format;
+}
+
+void bench::report(std::string_view const suite, std::string_view const name, double const value, std::string_view const unit)
+{
+    if (output == Output::Json)
+    {
+        fmt::print(R"({{"suite": "{}", "name": "{}", "unit": "{}", "value": {}}})" "\n", suite, name, unit, value);
+        return;
+    }
+    fmt::print("{:<10} {:<40} {:>14.2f} {}\n", suite, name, value, unit);
+}
+
+void bench::check(std::string_view const suite, std::string_view const name, bool const passed)
+{
+    if (passed) return;
+    fmt::print(stderr, "{}: {} failed\n", suite, name);
+    any_failed = true;
+}
+
+std::filesystem::path bench::temp_directory(std::string_view const suite)
+{
+#ifdef _WIN32
+    auto const pid = _getpid();
+#else
+    auto const pid = getpid();
+#endif
+#ifdef __BMI2__
+    auto const layout = SectionLayout::ID == MortonLayout::ID ? "morton_bmi2" : "linear_bmi2";
+#else
+    auto const layout = SectionLayout::ID == MortonLayout::ID ? "morton" : "linear";
+#endif
+    return std::filesystem::temp_directory_path() / fmt::format("minecraft2-bench-{}-{}-{}", suite, layout, pid);
+}
+
+bool bench::failed()
+{
+    return any_failed;
+}
+
+void bench::report(std::string_view const suite, std::string_view const name, Summary const& summary, std::string_view const unit)
+{
+    if (output == Output::Json)
+    {
+        fmt::print(
+            R"({{"suite": "{}", "name": "{}", "unit": "{}", "median": {}, "mean": {}, "stddev": {}, "min": {}, "max": {}, "runs": {}}})" "\n",
+            suite, name, unit, summary.median, summary.mean, summary.stddev, summary.min, summary.max, summary.runs);
+        return;
+    }
+    // Median first, it is what the other reports line up with
+    fmt::print("{:<10} {:<40} {:>14.2f} {} (±{:.2f}, {:.2f} to {:.2f}, {} runs)\n",
+        suite, name, summary.median, unit, summary.stddev, summary.min, summary.max, summary.runs);
+}
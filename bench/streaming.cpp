@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <thread>
+#include "bench.hpp"
+#include "jobs.hpp"
+#include "voxel/streamer.hpp"
+
+namespace
+{
+
+constexpr size_t UPDATES {4000};
+// Roughly one update per tick at 60 frames and 8 ticks per frame
+constexpr auto UPDATE_INTERVAL {std::chrono::microseconds{2000}};
+
+// Player flying in a straight line, what matters is how long the main thread spends in each update
+void fly(std::string_view const name, float const blocks_per_update)
+{
+    JobSystem jobs{std::max(std::thread::hardware_concurrency(), 2u)};
+    ChunkMap chunks;
+    TerrainGenerator const terrain{1337};
+    ChunkStreamer streamer{jobs, chunks, terrain, nullptr, StreamingSettings{}};
+
+    glm::vec3 position {8.f, 80.f, 8.f};
+    double total_ms{};
+    double worst_ms{};
+    uint32_t deepest_queue{};
+    for (size_t idx{}; idx < UPDATES; ++idx)
+    {
+        auto const next = bench::Clock::now() + UPDATE_INTERVAL;
+        position.x += blocks_per_update;
+        auto const elapsed = bench::time_ms([&] { streamer.update(position); });
+        total_ms += elapsed;
+        worst_ms = std::max(worst_ms, elapsed);
+        deepest_queue = std::max(deepest_queue, streamer.stats().waiting_for_generation);
+        std::this_thread::sleep_until(next);
+    }
+
+    auto const& stats = streamer.stats();
+    bench::report("streaming", fmt::format("{} update mean", name), total_ms * 1e3 / UPDATES, "us");
+    bench::report("streaming", fmt::format("{} update worst", name), worst_ms * 1e3, "us");
+    bench::report("streaming", fmt::format("{} loaded", name), stats.loaded_per_second, "chunks/s");
+    bench::report("streaming", fmt::format("{} deepest generation queue", name), deepest_queue, "chunks");
+    bench::report("streaming", fmt::format("{} meshed at the end", name), stats.meshed, "chunks");
+}
+
+} // namespace
+
+void bench::streaming()
+{
+    fly("standing", 0.f);
+    fly("walking", 0.01f);
+    fly("flying", 0.5f);
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include "voxel/chunk.hpp"
+#include "voxel/chunk_map.hpp"
+#include "worldgen/terrain.hpp"
+
+// Synthetic chunk contents and worlds shared by the benchmarks
+namespace bench
+{
+
+// Deterministic numbers, suites give the same results run to run
+struct Random
+{
+    uint32_t state;
+
+    float next(float const low, float const high)
+    {
+        state = state * 1664525u + 1013904223u;
+        return low + (high - low) * static_cast<float>(state >> 8) / static_cast<float>(1 << 24);
+    }
+
+    int next(int const bound)
+    {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<int>((state >> 8) % static_cast<uint32_t>(bound));
+    }
+};
+
+// Generated chunks from -radius to radius around the origin
+inline void generate(ChunkMap& chunks, TerrainGenerator const& terrain, int const radius)
+{
+    for (int z{-radius}; z <= radius; ++z)
+    {
+        for (int x{-radius}; x <= radius; ++x)
+        {
+            terrain.generate(*chunks.get(chunks.emplace({x, z})));
+        }
+    }
+}
+
+inline uint32_t hash(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352du;
+    value ^= value >> 15;
+    value *= 0x846ca68bu;
+    value ^= value >> 16;
+    return value;
+}
+
+inline void flat(Chunk& chunk, uint32_t)
+{
+    for (int y{}; y < 64; ++y)
+    {
+        auto const block = y < 60 ? Block::Stone : (y < 63 ? Block::Dirt : Block::Grass);
+        for (int z{}; z < SECTION_SIZE; ++z)
+        {
+            for (int x{}; x < SECTION_SIZE; ++x)
+            {
+                chunk.set(x, y, z, block);
+            }
+        }
+    }
+}
+
+// Blocky hills with some sand, roughly what generated terrain looks like
+inline void hills(Chunk& chunk, uint32_t const seed)
+{
+    for (int z{}; z < SECTION_SIZE; ++z)
+    {
+        for (int x{}; x < SECTION_SIZE; ++x)
+        {
+            int const height = 56 + static_cast<int>(hash(seed + (x / 4) * 31 + (z / 4) * 977) % 16);
+            for (int y{}; y <= height; ++y)
+            {
+                auto block = Block::Stone;
+                if (y == height) block = height < 60 ? Block::Sand : Block::Grass;
+                else if (y > height - 4) block = Block::Dirt;
+                chunk.set(x, y, z, block);
+            }
+        }
+    }
+}
+
+// Hills riddled with blobby caves, lots of faces hidden inside the ground
+inline void caves(Chunk& chunk, uint32_t const seed)
+{
+    hills(chunk, seed);
+    for (int y{1}; y < 56; ++y)
+    {
+        for (int z{}; z < SECTION_SIZE; ++z)
+        {
+            for (int x{}; x < SECTION_SIZE; ++x)
+            {
+                auto const cell = hash(seed * 31 + static_cast<uint32_t>((y / 3) * 4096 + (z / 3) * 64 + x / 3));
+                if (cell % 5 == 0) chunk.set(x, y, z, Block::Air);
+            }
+        }
+    }
+}
+
+// Lower half picked block by block at random, worst case for the palette
+inline void scrambled(Chunk& chunk, uint32_t const seed)
+{
+    constexpr auto block_count = static_cast<uint32_t>(Block::MAX_COUNT);
+    for (int y{}; y < CHUNK_HEIGHT / 2; ++y)
+    {
+        for (int z{}; z < SECTION_SIZE; ++z)
+        {
+            for (int x{}; x < SECTION_SIZE; ++x)
+            {
+                auto const value = hash(seed ^ static_cast<uint32_t>((y * SECTION_SIZE + z) * SECTION_SIZE + x));
+                chunk.set(x, y, z, static_cast<Block>(value % block_count));
+            }
+        }
+    }
+}
+
+// Every other block solid in all three directions, most faces any chunk can have
+inline void checkerboard(Chunk& chunk, uint32_t)
+{
+    for (int y{}; y < CHUNK_HEIGHT; ++y)
+    {
+        for (int z{}; z < SECTION_SIZE; ++z)
+        {
+            for (int x{}; x < SECTION_SIZE; ++x)
+            {
+                if ((x + y + z) % 2 == 0) chunk.set(x, y, z, Block::Stone);
+            }
+        }
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,150 @@
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+#include "jobs.hpp"
+#include "persist/chunk_codec.hpp"
+#include "persist/writer.hpp"
+#include "worldgen/terrain.hpp"
+
+namespace
+{
+
+constexpr int WORLD_SIZE {64};
+// Same pacing as the streaming bench, about one update per tick
+constexpr auto UPDATE_INTERVAL {std::chrono::microseconds{2000}};
+
+void generate(ChunkMap& chunks)
+{
+    JobSystem jobs;
+    TerrainGenerator const terrain{1337};
+    std::vector<Chunk*> generated;
+    for (int z{}; z < WORLD_SIZE; ++z)
+    {
+        for (int x{}; x < WORLD_SIZE; ++x)
+        {
+            generated.push_back(chunks.get(chunks.emplace({x, z})));
+        }
+    }
+    jobs.parallel_for(generated.size(), [&](size_t const idx) { terrain.generate(*generated[idx]); });
+}
+
+// A block somewhere in each of the first count chunks, so what is read back differs from freshly generated terrain
+void edit(ChunkMap& chunks, ChunkWriter& writer, int const round, size_t count)
+{
+    for (auto* chunk : chunks)
+    {
+        if (count-- == 0) return;
+        auto const x = (chunk->pos().x * 7 + round) & 15;
+        auto const z = (chunk->pos().z * 3 + round) & 15;
+        chunk->set(x, 100 + round % 20, z, Block::Stone);
+        writer.mark_dirty(chunk->pos());
+    }
+}
+
+struct Updates
+{
+    size_t count{};
+    double total_ms{};
+    double worst_ms{};
+};
+
+template <typename Done>
+Updates tick_until(ChunkWriter& writer, Done const& done)
+{
+    Updates updates;
+    while (not done())
+    {
+        auto const next = bench::Clock::now() + UPDATE_INTERVAL;
+        auto const elapsed = bench::time_ms([&] { writer.update(); });
+        ++updates.count;
+        updates.total_ms += elapsed;
+        updates.worst_ms = std::max(updates.worst_ms, elapsed);
+        std::this_thread::sleep_until(next);
+    }
+    return updates;
+}
+
+// Every chunk of a big world dirty at once and due right away, the worst autosave there is
+void autosave(ChunkMap& world, std::filesystem::path const& directory)
+{
+    RegionStorage storage{directory};
+    {
+        WritebackSettings settings;
+        settings.autosave_delay = {};
+        ChunkWriter writer{world, storage, settings};
+        edit(world, writer, 0, world.size());
+
+        auto const start = bench::Clock::now();
+        auto const updates = tick_until(writer, [&] {
+            auto const& stats = writer.stats();
+            return stats.dirty == 0 and stats.queued == 0;
+        });
+        auto const seconds = std::chrono::duration<double>(bench::Clock::now() - start).count();
+        auto const& stats = writer.stats();
+
+        bench::report("writeback", "autosave chunks", static_cast<double>(stats.written), "");
+        bench::report("writeback", "autosave drained in", seconds * 1e3, "ms");
+        bench::report("writeback", "autosave written", static_cast<double>(stats.written) / seconds, "chunks/s");
+        bench::report("writeback", "autosave update mean", updates.total_ms * 1e3 / static_cast<double>(updates.count), "us");
+        bench::report("writeback", "autosave update worst", updates.worst_ms * 1e3, "us");
+        bench::report("writeback", "autosave worst hitch", stats.worst_hitch_ms * 1e3, "us");
+        bench::report("writeback", "autosave backpressured updates", static_cast<double>(stats.backpressure), "");
+        bench::report("writeback", "autosave batches", static_cast<double>(stats.batches), "");
+    }
+
+    // Dropping the writer flushed everything, a fresh storage has to read back exactly what was edited
+    RegionStorage reopened{directory};
+    size_t different{};
+    std::vector<uint8_t> expected;
+    std::vector<uint8_t> actual;
+    for (auto const* chunk : world)
+    {
+        Chunk loaded{chunk->pos()};
+        expected.clear();
+        actual.clear();
+        encode_chunk(*chunk, expected);
+        if (reopened.load(loaded)) encode_chunk(loaded, actual);
+        different += expected != actual;
+    }
+    bench::report("writeback", "autosave round trip mismatches", static_cast<double>(different), "chunks");
+    bench::check("writeback", "autosave round trip", different == 0);
+}
+
+// A player building, the same chunks edited every update. Each one should be written about once per autosave delay
+void coalescing(ChunkMap& world, std::filesystem::path const& directory)
+{
+    constexpr int ROUNDS {500};
+    constexpr size_t EDITED_CHUNKS {64};
+    RegionStorage storage{directory};
+    WritebackSettings settings;
+    settings.autosave_delay = std::chrono::milliseconds{250};
+    ChunkWriter writer{world, storage, settings};
+
+    int round{};
+    auto const updates = tick_until(writer, [&] {
+        if (round == ROUNDS) return true;
+        edit(world, writer, round++, EDITED_CHUNKS);
+        return false;
+    });
+    auto const edits = static_cast<double>(ROUNDS * EDITED_CHUNKS);
+    auto const written = static_cast<double>(writer.stats().written);
+    bench::report("writeback", "coalescing edits", edits, "");
+    bench::report("writeback", "coalescing written by the end", written, "chunks");
+    bench::report("writeback", "coalescing update worst", updates.worst_ms * 1e3, "us");
+}
+
+} // namespace
+
+void bench::writeback()
+{
+    auto const directory = bench::temp_directory("writeback");
+    std::filesystem::remove_all(directory);
+
+    ChunkMap world{WORLD_SIZE * WORLD_SIZE};
+    generate(world);
+    autosave(world, directory);
+    coalescing(world, directory);
+
+    std::filesystem::remove_all(directory);
+}
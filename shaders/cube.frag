@@ -1,14 +1,17 @@
 #version 450
 
-layout(set = 1, binding = 0) uniform sampler2D textureSampler;
+layout(set = 1, binding = 0) uniform sampler2DArray textureSampler;
 
 layout (location = 0) in vec2 texCoord;
+layout (location = 1) in vec3 light;
+// Of the block texture array, one per block type
+layout (location = 2) flat in uint layer;
 
 layout(location = 0) out vec4 fragColor;
 
 void main()
 {
-    vec3 color = texture(textureSampler, texCoord).xyz;
-    fragColor = vec4(color, 1.0);
+    vec3 color = texture(textureSampler, vec3(texCoord, float(layer))).xyz;
+    fragColor = vec4(color * light, 1.0);
 }
 
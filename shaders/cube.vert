@@ -6,14 +6,50 @@ layout(set = 0, binding = 0) uniform UniformBufferObj {
     mat4 projection;
 } camera;
 
-layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 uv;
+layout(push_constant) uniform ChunkConstants {
+    vec4 origin;
+} chunk;
+
+// PackedVertex, see gfx/vertex.hpp
+layout(location = 0) in uint inPosition;
+layout(location = 1) in uint inAttributes;
 
 layout(location = 0) out vec2 textureCoord;
+layout(location = 1) out vec3 light;
+layout(location = 2) flat out uint layer;
+
+// Every level darker than full takes a fifth off
+float brightness(uint level)
+{
+    return pow(0.8, float(15u - level));
+}
 
 void main()
 {
-    gl_Position = camera.projection * camera.view * camera.model * vec4(position, 1.0);
-    textureCoord = uv;
+    vec3 position = vec3(
+        float(inPosition & 31u),
+        float((inPosition >> 5) & 511u),
+        float((inPosition >> 14) & 31u)
+    );
+    uint axis = ((inPosition >> 19) & 7u) / 2u;
+
+    // Textures repeat once per block, merged quads don't need their own uvs
+    if (axis == 1u) {
+        textureCoord = position.xz;
+    } else if (axis == 0u) {
+        textureCoord = vec2(position.z, -position.y);
+    } else {
+        textureCoord = vec2(position.x, -position.y);
+    }
+
+    layer = inAttributes & 255u;
+
+    // Lamps shine a little warmer than the sky
+    float sky = brightness((inAttributes >> 10) & 15u);
+    float lamp = brightness((inAttributes >> 14) & 15u);
+    // Fully occluded corners keep a bit over half their light
+    float occlusion = 0.55 + 0.15 * float((inAttributes >> 8) & 3u);
+    light = max(vec3(sky), lamp * vec3(1.0, 0.9, 0.75)) * occlusion;
+
+    gl_Position = camera.projection * camera.view * camera.model * vec4(position + chunk.origin.xyz, 1.0);
 }
@@ -1,13 +1,18 @@
 #include "app.hpp"
+#include "log.hpp"
+#include "profiler.hpp"
 
 
-
-App::App(std::string name):
+App::App(std::string name, AppOptions const& options):
     name_{std::move(name)},
     window_{name_.c_str(), 800, 600},
     input_{window_.handle()},
-    world_{window_.size(), FRAMES_PER_SECOND / static_cast<float>(TICKS_PER_FRAME)},
-    renderer_{window_}
+    // Chunk streaming never waits on its jobs, so there has to be at least one worker to run them
+    jobs_{std::max(std::thread::hardware_concurrency(), 2u)},
+    world_{jobs_, window_.size(), 1.f / TICKS_PER_SECOND},
+    renderer_{window_},
+    recorder_{options.record.empty() ? nullptr : std::make_unique<InputRecorder>(options.record, 1.f / TICKS_PER_SECOND)},
+    simulation_{world_, jobs_, TICKS_PER_SECOND, recorder_.get()}
 {}
 
 App::~App() 
@@ -17,19 +22,38 @@ App::~App()
 
 void App::run() 
 {
+    auto next_report = LoopTimer::Clock::now() + REPORT_INTERVAL;
     while (not window_.should_close()) 
     {
+        PROFILE_SCOPE("frame");
+        auto const start = LoopTimer::Clock::now();
         window_.poll();
-        auto const actions = input_.actions();
-        if (std::find(actions.user_actions.begin(), actions.user_actions.end(), Action::Terminate) != actions.user_actions.end()) break;
+        input_.actions(actions_);
+        if (std::find(actions_.user_actions.begin(), actions_.user_actions.end(), Action::Terminate) != actions_.user_actions.end()) break;
+
+        // The world ticks on its own thread, the frame draws whatever it published last
+        simulation_.post(actions_);
+        renderer_.draw(simulation_.latest());
+        input_.update();
+        frame_timer_.record(LoopTimer::Clock::now() - start);
 
-        for(uint8_t idx{}; idx < TICKS_PER_FRAME; ++idx) 
+        if (start >= next_report)
         {
-            world_.tick(actions);
+            report();
+            next_report = start + REPORT_INTERVAL;
         }
-        
-        renderer_.draw(world_.to_render());
-        input_.update();
     }
 }
 
+void App::report()
+{
+    auto const ticks = simulation_.timer().take();
+    auto const frames = frame_timer_.take();
+    auto const gpu = renderer_.gpu_timer().take();
+    auto const& last = renderer_.gpu_times();
+    debug("Simulation {:.0f} ticks/s, {:.2f} ms mean, {:.2f} ms worst", ticks.per_second, ticks.mean_ms, ticks.worst_ms);
+    debug("Rendering {:.0f} frames/s, CPU {:.2f} ms mean, {:.2f} ms worst, GPU {:.2f} ms mean, {:.2f} ms worst",
+        frames.per_second, frames.mean_ms, frames.worst_ms, gpu.mean_ms, gpu.worst_ms);
+    debug("Last GPU frame {:.2f} ms uploading, {:.2f} ms in the render pass", last.uploads, last.pass);
+}
+
@@ -1,14 +1,24 @@
 #pragma once
+#include <filesystem>
+#include <memory>
 #include <string>
 #include "gfx/renderer.hpp"
 #include "input.hpp"
+#include "loop_timer.hpp"
+#include "simulation.hpp"
 #include "window.hpp"
 #include "world.hpp"
 
 
+struct AppOptions
+{
+    // Where to record the session's input, nowhere when empty
+    std::filesystem::path record;
+};
+
 class App {
 public:
-    App(std::string name);
+    App(std::string name, AppOptions const& options = {});
     ~App();
     
     App(App const&) = delete;
@@ -19,12 +29,22 @@ public:
     void run();
     
 private:
-    static constexpr uint8_t FRAMES_PER_SECOND {60};
-    static constexpr uint8_t TICKS_PER_FRAME {8};
+    static constexpr float TICKS_PER_SECOND {480.f};
+    // How often both loops log their rates
+    static constexpr std::chrono::seconds REPORT_INTERVAL {5};
+
+    void report();
 
     std::string name_;
     Window window_;
     InputCollector input_;
+    JobSystem jobs_;
     World world_; 
     Renderer renderer_;
+    LoopTimer frame_timer_;
+    // Refilled every frame
+    UserInput actions_;
+    std::unique_ptr<InputRecorder> recorder_;
+    // Declared last, its thread has to stop before the world goes away
+    Simulation simulation_;
 };
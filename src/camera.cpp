@@ -15,10 +15,14 @@ PerspectiveCamera::PerspectiveCamera(glm::uvec2 const& extent):
     target{0.f},
     view{0.f},
     projection{glm::perspective(fov, aspect_rato, znear, zfar)}
-{}
+{
+    // Vulkan clip space has y pointing down, keep +y as up in the world
+    projection[1][1] *= -1.f;
+}
 
 
-constexpr float sensitivity {0.1f};
+// Mouse movement is applied once per frame it was seen in, not once per tick
+constexpr float sensitivity {0.8f};
 
 void PerspectiveCamera::update(glm::vec3 const& pos, glm::vec2 const& movement)
 {
@@ -26,7 +30,7 @@ void PerspectiveCamera::update(glm::vec3 const& pos, glm::vec2 const& movement)
     yaw += glm::radians(movement.x * sensitivity);
     yaw = fmodf(yaw, glm::two_pi<float>());
 
-    pitch += glm::radians(movement.y * sensitivity);
+    pitch -= glm::radians(movement.y * sensitivity);
     pitch = glm::clamp(pitch, glm::radians(-89.f), glm::radians(89.f));
 
     target = glm::normalize(glm::vec3{
@@ -37,3 +41,31 @@ void PerspectiveCamera::update(glm::vec3 const& pos, glm::vec2 const& movement)
     view = glm::lookAt(position, position + target, up_dir);
 }
 
+Frustum::Frustum(PerspectiveCamera const& camera)
+{
+    // Gribb and Hartmann: the planes are sums of the rows of the view projection matrix, depth is in [0, 1]
+    auto const matrix = glm::transpose(camera.projection * camera.view);
+    planes = {
+        matrix[3] + matrix[0],
+        matrix[3] - matrix[0],
+        matrix[3] + matrix[1],
+        matrix[3] - matrix[1],
+        matrix[2],
+        matrix[3] - matrix[2],
+    };
+}
+
+bool Frustum::intersects(glm::vec3 const& min, glm::vec3 const& max) const
+{
+    for (auto const& plane : planes)
+    {
+        // The corner furthest along the plane normal
+        glm::vec3 const corner {
+            plane.x > 0.f ? max.x : min.x,
+            plane.y > 0.f ? max.y : min.y,
+            plane.z > 0.f ? max.z : min.z,
+        };
+        if (glm::dot(glm::vec3{plane}, corner) + plane.w < 0.f) return false;
+    }
+    return true;
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <glm/glm.hpp>
 
 struct PerspectiveCamera {
@@ -10,3 +11,14 @@ struct PerspectiveCamera {
     glm::mat4 view, projection;
 };
 
+// The six planes bounding what a camera sees, pointing inwards
+struct Frustum
+{
+    explicit Frustum(PerspectiveCamera const& camera);
+
+    // Conservative, boxes close to a corner may pass without being visible
+    [[nodiscard]] bool intersects(glm::vec3 const& min, glm::vec3 const& max) const;
+
+    std::array<glm::vec4, 6> planes;
+};
+
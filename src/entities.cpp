@@ -0,0 +1,159 @@
+#include <utility>
+#include "entities.hpp"
+
+namespace
+{
+
+void reserve_axes(Axes& axes, size_t const count)
+{
+    axes.x.reserve(count);
+    axes.y.reserve(count);
+    axes.z.reserve(count);
+}
+
+// In blocks of a fixed size, at -O2 the compiler only vectorizes loops which need no scalar remainder
+void advance(float* __restrict position, float const* __restrict velocity, size_t const count, float const dt)
+{
+    constexpr size_t BLOCK {8};
+    size_t idx{};
+    for (; idx + BLOCK <= count; idx += BLOCK)
+    {
+        for (size_t lane{}; lane < BLOCK; ++lane)
+        {
+            position[idx + lane] += velocity[idx + lane] * dt;
+        }
+    }
+    for (; idx < count; ++idx)
+    {
+        position[idx] += velocity[idx] * dt;
+    }
+}
+
+} // namespace
+
+Entities::Entities(size_t const expected)
+{
+    reserve(expected);
+}
+
+void Entities::reserve(size_t const count)
+{
+    reserve_axes(positions, count);
+    reserve_axes(velocities, count);
+    widths.reserve(count);
+    heights.reserve(count);
+    flags_.reserve(count);
+    slots_.reserve(count);
+    free_slots_.reserve(count);
+    dense_slots_.reserve(count);
+    bodies_.reserve(count);
+}
+
+EntityId Entities::spawn(glm::vec3 const& position, glm::vec2 const& size, uint8_t const flags)
+{
+    uint32_t slot{};
+    if (free_slots_.empty())
+    {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+    else
+    {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    }
+
+    positions.x.push_back(position.x);
+    positions.y.push_back(position.y);
+    positions.z.push_back(position.z);
+    velocities.x.push_back(0.f);
+    velocities.y.push_back(0.f);
+    velocities.z.push_back(0.f);
+    widths.push_back(size.x);
+    heights.push_back(size.y);
+    flags_.push_back(flags);
+    dense_slots_.push_back(slot);
+    auto dense = static_cast<uint32_t>(flags_.size() - 1);
+    slots_[slot].dense = dense;
+
+    // Colliding ones go to the end of their range, the first free entity moves to the back to make room
+    if (flags & COLLIDES)
+    {
+        swap(dense, colliding_);
+        ++colliding_;
+    }
+    return {slot, slots_[slot].generation};
+}
+
+bool Entities::despawn(EntityId const id)
+{
+    auto dense = index(id);
+    if (dense == EntityId::INVALID) return false;
+
+    // Into the last place of its range, then the last entity fills the hole left at the end of the colliding ones
+    if (dense < colliding_)
+    {
+        --colliding_;
+        swap(dense, colliding_);
+        dense = colliding_;
+    }
+    swap(dense, static_cast<uint32_t>(size() - 1));
+
+    positions.x.pop_back();
+    positions.y.pop_back();
+    positions.z.pop_back();
+    velocities.x.pop_back();
+    velocities.y.pop_back();
+    velocities.z.pop_back();
+    widths.pop_back();
+    heights.pop_back();
+    flags_.pop_back();
+    dense_slots_.pop_back();
+
+    ++slots_[id.slot].generation;
+    free_slots_.push_back(id.slot);
+    return true;
+}
+
+void Entities::swap(uint32_t const a, uint32_t const b)
+{
+    if (a == b) return;
+    for (auto* axes : {&positions, &velocities})
+    {
+        std::swap(axes->x[a], axes->x[b]);
+        std::swap(axes->y[a], axes->y[b]);
+        std::swap(axes->z[a], axes->z[b]);
+    }
+    std::swap(widths[a], widths[b]);
+    std::swap(heights[a], heights[b]);
+    std::swap(flags_[a], flags_[b]);
+    std::swap(dense_slots_[a], dense_slots_[b]);
+    slots_[dense_slots_[a]].dense = a;
+    slots_[dense_slots_[b]].dense = b;
+}
+
+void Entities::move(float const dt)
+{
+    auto const count = size() - colliding_;
+    advance(positions.x.data() + colliding_, velocities.x.data() + colliding_, count, dt);
+    advance(positions.y.data() + colliding_, velocities.y.data() + colliding_, count, dt);
+    advance(positions.z.data() + colliding_, velocities.z.data() + colliding_, count, dt);
+}
+
+void Entities::collide(Physics& physics, float const dt)
+{
+    bodies_.resize(colliding_);
+    for (uint32_t idx{}; idx < colliding_; ++idx)
+    {
+        bodies_[idx] = {positions.get(idx), velocities.get(idx), {widths[idx], heights[idx]}, (flags_[idx] & ON_GROUND) != 0};
+    }
+
+    physics.step(bodies_, dt);
+
+    for (uint32_t idx{}; idx < colliding_; ++idx)
+    {
+        positions.set(idx, bodies_[idx].position);
+        velocities.set(idx, bodies_[idx].velocity);
+        flags_[idx] = static_cast<uint8_t>((flags_[idx] & ~ON_GROUND) | (bodies_[idx].on_ground ? ON_GROUND : 0));
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+#include "voxel/physics.hpp"
+
+// Survives other entities being removed, goes stale once its own entity is despawned
+struct EntityId
+{
+    static constexpr uint32_t INVALID {std::numeric_limits<uint32_t>::max()};
+
+    uint32_t slot{INVALID};
+    uint32_t generation{0};
+
+    [[nodiscard]] bool valid() const
+    {
+        return slot != INVALID;
+    }
+
+    auto operator<=>(EntityId const& other) const = default;
+};
+
+// One float array per axis, so systems run over each of them as plain contiguous loops
+struct Axes
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+
+    [[nodiscard]] glm::vec3 get(size_t const idx) const
+    {
+        return {x[idx], y[idx], z[idx]};
+    }
+
+    void set(size_t const idx, glm::vec3 const& value)
+    {
+        x[idx] = value.x;
+        y[idx] = value.y;
+        z[idx] = value.z;
+    }
+};
+
+// Every entity has every component, each component is its own densely packed array and index idx of all of them
+// belongs to the same entity. Colliding entities come first, the others after them, so every system runs over one
+// contiguous range without looking at flags. Despawning swaps the last entity into the hole (twice for colliding
+// ones, the range must stay packed), so indices change, ids don't.
+// Spawning only allocates when the arrays have to grow, reserve() up front and it never does.
+class Entities
+{
+public:
+    // Moved by Physics, with gravity and collisions. The others fly in a straight line. Fixed at spawn
+    static constexpr uint8_t COLLIDES {1 << 0};
+    static constexpr uint8_t ON_GROUND {1 << 1};
+
+    explicit Entities(size_t const expected = 0);
+
+    void reserve(size_t const count);
+    EntityId spawn(glm::vec3 const& position, glm::vec2 const& size, uint8_t const flags);
+    bool despawn(EntityId const id);
+
+    // Dense index of the entity, EntityId::INVALID for stale ids
+    [[nodiscard]] uint32_t index(EntityId const id) const
+    {
+        if (id.slot >= slots_.size() or slots_[id.slot].generation != id.generation) return EntityId::INVALID;
+        return slots_[id.slot].dense;
+    }
+
+    [[nodiscard]] EntityId id(size_t const idx) const
+    {
+        auto const slot = dense_slots_[idx];
+        return {slot, slots_[slot].generation};
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return flags_.size();
+    }
+
+    // Colliding entities are the ones from 0 up to this
+    [[nodiscard]] size_t colliding() const
+    {
+        return colliding_;
+    }
+
+    // Systems, each one pass over the arrays
+    void move(float const dt);
+    void collide(Physics& physics, float const dt);
+
+    // Components, indexed by dense index
+    Axes positions;
+    Axes velocities;
+    // Width along x and z, height
+    std::vector<float> widths;
+    std::vector<float> heights;
+
+    [[nodiscard]] std::vector<uint8_t> const& flags() const
+    {
+        return flags_;
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t dense{0};
+        uint32_t generation{0};
+    };
+
+    void swap(uint32_t const a, uint32_t const b);
+
+    std::vector<uint8_t> flags_;
+    uint32_t colliding_{0};
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+    std::vector<uint32_t> dense_slots_;
+    // Colliding entities as bodies for Physics, in the same order
+    std::vector<Body> bodies_;
+};
@@ -59,7 +59,6 @@ bool suitable(VkPhysicalDevice const device, VkSurfaceKHR const surface)
 {
     return 
         supports_extensions(device) 
-        and is_external_gpu(device) 
         and QueueFamily {device, surface}.exists()
         and SwapChainSupportDetails::create(device, surface).supported();
 }
@@ -71,7 +70,12 @@ VkPhysicalDevice best_physical_device(VkInstance const instance, VkSurfaceKHR co
     std::vector<VkPhysicalDevice> devices;
     devices.resize(device_count);
     vkEnumeratePhysicalDevices(instance, &device_count, devices.data());
-    auto const found_it = std::find_if(devices.begin(), devices.end(), [&surface](auto const& arg) {return suitable(arg, surface);});
+    auto found_it = std::find_if(devices.begin(), devices.end(), [&surface](auto const& arg) {return suitable(arg, surface) and is_external_gpu(arg);});
+    // Integrated and software ones (lavapipe, for CI) still do when there is no discrete GPU
+    if (found_it == devices.end())
+    {
+        found_it = std::find_if(devices.begin(), devices.end(), [&surface](auto const& arg) {return suitable(arg, surface);});
+    }
     if (found_it == devices.end())
     {
         fail("No device connected");
@@ -11,7 +11,8 @@ Framedata::Framedata(Device& device, VkSurfaceKHR const surface) :
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT},
         cmd{device, surface, QueueFamily{device.physical(), surface}.get_queue(device.logical())},
         image_acquired{device},
-        image_rendered{device}
+        image_rendered{device},
+        timestamps{device, surface}
 {}
 
 
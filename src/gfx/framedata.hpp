@@ -3,6 +3,7 @@
 #include "commands.hpp"
 #include "descriptors.hpp"
 #include "semaphore.hpp"
+#include "timestamps.hpp"
 
 constexpr uint8_t FRAME_OVERLAP {2u};
 
@@ -15,6 +16,7 @@ struct Framedata
     CommandBuffer cmd;
     Semaphore image_acquired;
     Semaphore image_rendered;
+    FrameTimestamps timestamps;
     VkDescriptorSet texture_descriptor; 
     VkDescriptorSet unfirom_descriptor;
 };
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <assert.h>
 #include "image.hpp"
 #include "utils.hpp"
@@ -10,7 +11,8 @@ namespace
 VkImageCreateInfo image_create_info(
     VkFormat const format,
     VkExtent2D const extent,
-    VkImageUsageFlags const usage)
+    VkImageUsageFlags const usage,
+    uint32_t const array_layers)
 {
     VkImageCreateInfo create_info {};
     create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -18,7 +20,7 @@ VkImageCreateInfo image_create_info(
     create_info.format = format;
     create_info.extent = {extent.width, extent.height, 1};
     create_info.mipLevels = 1;
-    create_info.arrayLayers = 1;
+    create_info.arrayLayers = std::max(array_layers, 1u);
     create_info.samples = VK_SAMPLE_COUNT_1_BIT;
     create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
     create_info.usage = usage;
@@ -29,19 +31,20 @@ VkImageCreateInfo image_create_info(
 VkImageViewCreateInfo image_view_create_info(
     VkFormat const format,
     VkImage const image,
-    VkImageAspectFlags const aspects) 
+    VkImageAspectFlags const aspects,
+    uint32_t const array_layers) 
 {
     VkImageViewCreateInfo info {};
     info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     info.format = format;
     info.image = image;
-    info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    info.viewType = array_layers == 0 ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_2D_ARRAY;
     info.subresourceRange = {
         .aspectMask = aspects,
         .baseMipLevel = 0,
         .levelCount = 1,
         .baseArrayLayer = 0,
-        .layerCount = 1,
+        .layerCount = std::max(array_layers, 1u),
     };
     return info;
 }
@@ -55,12 +58,14 @@ Image::Image(
     VkFormat const format,
     VkExtent2D const extent,
     VkImageUsageFlags const usage,
-    VkImageAspectFlags const aspect):
+    VkImageAspectFlags const aspect,
+    uint32_t const array_layers):
     device_{device},
     format_{format},
     extent_{extent},
     usage_{usage},
     aspect_{aspect},
+    array_layers_{array_layers},
     image_{create_image()},
     memory_{allocate_memory()},
     view_{create_image_view()}
@@ -68,7 +73,7 @@ Image::Image(
  
 VkImage Image::create_image() const
 {
-    auto const image_info = image_create_info(format_, extent_, usage_);
+    auto const image_info = image_create_info(format_, extent_, usage_, array_layers_);
     VkImage image;
     utils::check_vk(vkCreateImage(device_.logical(), &image_info, nullptr, &image));
     return image;
@@ -76,7 +81,7 @@ VkImage Image::create_image() const
 
 VkImageView Image::create_image_view() const 
 {
-    auto const view_info = image_view_create_info(format_, image_, aspect_);
+    auto const view_info = image_view_create_info(format_, image_, aspect_, array_layers_);
     VkImageView view;
     utils::check_vk(vkCreateImageView(device_.logical(), &view_info, nullptr, &view));
     return view;
@@ -100,11 +105,13 @@ void Image::fill(void const* src, size_t const size)
     VkMemoryRequirements mem_reqs;
     vkGetImageMemoryRequirements(device_.logical(), image_, &mem_reqs);
     assert(size <= mem_reqs.size);
+    auto const layers = std::max(array_layers_, 1u);
 
+    // Sized like the source, the image's memory may be padded past it
     GpuBuffer staging_buffer 
     {
         device_,
-        mem_reqs.size,
+        size,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
     };
@@ -117,7 +124,7 @@ void Image::fill(void const* src, size_t const size)
             .baseMipLevel = 0,
             .levelCount = 1,
             .baseArrayLayer = 0,
-            .layerCount = 1,
+            .layerCount = layers,
         };
 
         VkImageMemoryBarrier imageBarrier_toTransfer {};
@@ -151,7 +158,7 @@ void Image::fill(void const* src, size_t const size)
         copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         copyRegion.imageSubresource.mipLevel = 0;
         copyRegion.imageSubresource.baseArrayLayer = 0;
-        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageSubresource.layerCount = layers;
         copyRegion.imageExtent = {extent_.width, extent_.height, 1};
 
 
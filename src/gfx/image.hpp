@@ -13,9 +13,11 @@ public:
         VkFormat const format,
         VkExtent2D const extent,
         VkImageUsageFlags const usage,
-        VkImageAspectFlags const aspect
+        VkImageAspectFlags const aspect,
+        uint32_t const array_layers = 0
     );
 
+    // Every layer, one after another
     void fill(void const* src, size_t const size);
 
     ~Image();
@@ -31,6 +33,8 @@ private:
     VkExtent2D extent_;
     VkImageUsageFlags usage_;
     VkImageAspectFlags aspect_;
+    // 0 for a plain 2D image, viewed as a 2D array otherwise
+    uint32_t array_layers_;
 
     VkImage image_;
     VkDeviceMemory memory_;
@@ -78,6 +78,8 @@ VkPipelineLayout PipelineBuilder::create_pipeline_layout(VkDevice const device)
     info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     info.setLayoutCount = descriptor_layouts_.size();
     info.pSetLayouts = descriptor_layouts_.data();
+    info.pushConstantRangeCount = push_constants_.size();
+    info.pPushConstantRanges = push_constants_.data();
     VkPipelineLayout layout;
     utils::check_vk(vkCreatePipelineLayout(device, &info, nullptr, &layout));
     return layout;
@@ -121,8 +123,8 @@ PipelineBuilder PipelineBuilder::set_descriptions(Descriptions const& descriptio
         .flags = 0,
         .vertexBindingDescriptionCount = 1,
         .pVertexBindingDescriptions = &descriptions_.binding,
-        .vertexAttributeDescriptionCount = Vertex::COUNT,
-        .pVertexAttributeDescriptions = reinterpret_cast<VkVertexInputAttributeDescription*>(&descriptions_.attribute)
+        .vertexAttributeDescriptionCount = descriptions_.attribute_count,
+        .pVertexAttributeDescriptions = descriptions_.attributes.data()
     };
     return *this;
 }
@@ -133,6 +135,17 @@ PipelineBuilder PipelineBuilder::set_descriptor_sets(VkDescriptorSetLayout ubo,
 }
 
 
+PipelineBuilder PipelineBuilder::add_push_constants(VkShaderStageFlags const stages, uint32_t const size)
+{
+    uint32_t offset{0};
+    if (not push_constants_.empty())
+    {
+        offset = push_constants_.back().offset + push_constants_.back().size;
+    }
+    push_constants_.push_back({.stageFlags = stages, .offset = offset, .size = size});
+    return *this;
+}
+
 PipelineBuilder PipelineBuilder::set_render_pass(VkRenderPass render_pass) 
 {
     render_pass_ = render_pass; 
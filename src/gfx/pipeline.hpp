@@ -17,6 +17,7 @@ public:
 
     PipelineBuilder set_shader(Shader const& shader);
     PipelineBuilder set_descriptor_sets(VkDescriptorSetLayout ubo, VkDescriptorSetLayout texture);
+    PipelineBuilder add_push_constants(VkShaderStageFlags const stages, uint32_t const size);
     PipelineBuilder set_viewport(Viewport const& viewport);
     PipelineBuilder set_render_pass(VkRenderPass render_pass);
     PipelineBuilder set_descriptions(Descriptions const& descriptors);
@@ -41,5 +42,6 @@ private:
     VkPipelineVertexInputStateCreateInfo vertex_info_;
     Descriptions descriptions_;
     std::vector<VkDescriptorSetLayout> descriptor_layouts_;
+    std::vector<VkPushConstantRange> push_constants_;
 };
 
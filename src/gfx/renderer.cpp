@@ -1,7 +1,10 @@
+#include <algorithm>
 #include <span>
 #include "renderer.hpp"
 #include "uniforms.hpp"
 #include "log.hpp"
+#include "profiler.hpp"
+#include "voxel/block.hpp"
 
 namespace 
 {
@@ -104,7 +107,8 @@ Pipeline new_pipeline(
         .set_descriptor_sets(ubo, texture)
         .set_viewport(viewport)
         .set_render_pass(render_pass)
-        .set_descriptions(Vertex::descriptions())
+        .set_descriptions(PackedVertex::descriptions())
+        .add_push_constants(VK_SHADER_STAGE_VERTEX_BIT, sizeof(ChunkConstants))
         .set_depth_testing(depth_stencil_create_info())
         .build(device.logical());
 }
@@ -138,52 +142,6 @@ VkDescriptorSetLayout create_descriptor_set_layout(
     return descriptor_set_layout;
 }
 
-GpuBuffer index_buff(Device& device, std::span<uint16_t const> indicies)
-{
-    auto const buff_size = sizeof(uint16_t) * indicies.size();
-    GpuBuffer transfer {
-        device,
-        buff_size,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    };
-
-    GpuBuffer target {
-        device,
-        buff_size,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-    };
-    
-    transfer.fill(indicies.data());
-    target.copy_from(transfer);
-    return target;
-}
-
-GpuBuffer vertex_buff(Device& device, std::span<Vertex const> verticies)
-{
-    
-    auto const size = sizeof(Vertex) * verticies.size();
-    GpuBuffer transfer 
-    {
-        device,
-        size,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    };
-    GpuBuffer target 
-    {
-        device,
-        size,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-    };
-    
-    transfer.fill(verticies.data());
-    target.copy_from(transfer);
-    return target;
-}
-
 constexpr VkClearValue clear_color{{{0.f, 157.f / 256.f, 196.f / 256.f, 1.f}}};
 constexpr VkClearValue clear_depth {.depthStencil = {.depth = 1.f, .stencil = 0}};
 constexpr std::array clear_clrs {clear_color, clear_depth};
@@ -222,6 +180,12 @@ VkSampler create_sampler(
     return sampler;
 }
 
+// Files of the block texture array, layer by layer. Blocks without a texture of their own show dirt
+std::vector<std::string> block_textures()
+{
+    return std::vector<std::string>(TEXTURE_LAYERS, "dirt.png");
+}
+
 VkRenderPass new_pass(Device const& device, VkFormat const color_format, VkFormat const depth_format)
 {
     VkAttachmentDescription color_attachement
@@ -358,7 +322,7 @@ Renderer::Renderer(Window& window) :
     sampler_{create_sampler(device_, VK_FILTER_NEAREST)},
     depth_{device_, VK_FORMAT_D32_SFLOAT, extent_, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT},
     frame_buffers_{new_frame_buffers(device_, swapchain_, extent_, render_pass_, depth_.view())},
-    texture_{device_, "dirt.png"},
+    texture_{device_, block_textures()},
     frames_{
         device_,
         surface_,
@@ -368,6 +332,7 @@ Renderer::Renderer(Window& window) :
         sampler_
     }
 {
+    if (not frames_.data[0].timestamps.supported()) warn("The queue can't write timestamps, there will be no GPU frame times");
     info("Renderer intialized");
 }
 
@@ -391,6 +356,7 @@ void Renderer::handle_world_data(RenderData const& data)
 
 std::optional<uint32_t> Renderer::acquire_image()
 {
+    PROFILE_SCOPE("acquire_image");
     uint32_t image_index{};
     auto const result = vkAcquireNextImageKHR(
         device_.logical(),
@@ -410,62 +376,215 @@ std::optional<uint32_t> Renderer::acquire_image()
 }
 
 
-// Need some chunk data bookkeeping, given some chunks,
-// e.g check if data is already allocated otherwiser setup GPU resources
-void Renderer::draw(RenderData const& render_data) 
+void Renderer::retire(GpuMesh&& mesh)
+{
+    retired_[frame_number_ % FRAME_OVERLAP].push_back(std::move(mesh));
+}
+
+GpuBuffer Renderer::stage(std::span<std::byte const> data, VkBufferUsageFlags const usage)
+{
+    GpuBuffer staging 
+    {
+        device_,
+        data.size(),
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    };
+    GpuBuffer target 
+    {
+        device_,
+        data.size(),
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    };
+    staging.fill(data.data());
+    uploads_[frame_number_ % FRAME_OVERLAP].push_back({std::move(staging), target.handle()});
+    return target;
+}
+
+void Renderer::record_uploads(VkCommandBuffer const cmd)
 {
-    // For now:
-    static GpuBuffer index{index_buff(device_, render_data.indices)};
-    static GpuBuffer vertex{vertex_buff(device_, render_data.vertices)};
-    static size_t count{render_data.indices.size()};
+    auto const& uploads = uploads_[frame_number_ % FRAME_OVERLAP];
+    if (uploads.empty()) return;
 
+    for (auto const& upload : uploads)
+    {
+        VkBufferCopy const region
+        {
+            .srcOffset = 0,
+            .dstOffset = 0,
+            .size = upload.staging.size(),
+        };
+        vkCmdCopyBuffer(cmd, upload.staging.handle(), upload.target, 1, &region);
+    }
+
+    // Done before the pass reads them as vertices and indices
+    VkMemoryBarrier const barrier
+    {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT,
+    };
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+// Of the frame this slot drew last time, its fence has signaled so reading them doesn't wait. Reading the frame still
+// in flight instead could race its reset of the queries and come back with the results from before
+void Renderer::take_gpu_times()
+{
+    if (auto const times = current_frame().timestamps.read())
+    {
+        gpu_times_ = *times;
+        gpu_timer_.record(std::chrono::duration_cast<LoopTimer::Clock::duration>(std::chrono::duration<double, std::milli>{times->frame}));
+    }
+}
+
+// Takes the updates it hasn't seen yet and uploads the nearest of the changed meshes, the rest waits for the
+// next frames. Drawing goes by handle, so nothing here looks at meshes that didn't change
+void Renderer::sync_meshes(std::span<MeshUpdate const> updates, glm::vec3 const& viewer)
+{
+    PROFILE_SCOPE("sync_meshes");
+    for (auto const& update : updates)
+    {
+        if (update.sequence <= mesh_sequence_) continue;
+        mesh_sequence_ = update.sequence;
+        if (update.handle >= meshes_.size()) meshes_.resize(update.handle + 1);
+
+        auto& slot = meshes_[update.handle];
+        slot.pending = update.mesh;
+        // Stale meshes keep being drawn until their replacement gets uploaded, unless the handle went to another chunk
+        auto const reused = slot.gpu.has_value() and (update.mesh == nullptr or update.mesh->pos != slot.gpu->pos);
+        if (reused)
+        {
+            retire(std::move(*slot.gpu));
+            slot.gpu.reset();
+        }
+        if (slot.pending != nullptr and not slot.queued)
+        {
+            slot.queued = true;
+            pending_uploads_.push_back(update.handle);
+        }
+    }
+    std::erase_if(pending_uploads_, [&](MeshHandle const handle) {
+        auto& slot = meshes_[handle];
+        slot.queued = slot.pending != nullptr;
+        return not slot.queued;
+    });
+
+    auto const upload_count = std::min(pending_uploads_.size(), MAX_UPLOADS_PER_FRAME);
+    auto const distance = [&](MeshHandle const handle) {
+        auto const pos = meshes_[handle].pending->pos;
+        auto const dx = static_cast<float>(pos.x * SECTION_SIZE + SECTION_SIZE / 2) - viewer.x;
+        auto const dz = static_cast<float>(pos.z * SECTION_SIZE + SECTION_SIZE / 2) - viewer.z;
+        return dx * dx + dz * dz;
+    };
+    std::partial_sort(pending_uploads_.begin(), pending_uploads_.begin() + upload_count, pending_uploads_.end(),
+        [&](MeshHandle const a, MeshHandle const b) { return distance(a) < distance(b); });
+
+    for (size_t idx{}; idx < upload_count; ++idx)
+    {
+        auto& slot = meshes_[pending_uploads_[idx]];
+        auto const mesh = std::move(slot.pending);
+        slot.queued = false;
+        if (slot.gpu.has_value())
+        {
+            retire(std::move(*slot.gpu));
+            slot.gpu.reset();
+        }
+        if (mesh->empty()) continue;
+
+        slot.gpu.emplace(GpuMesh{
+            stage(std::as_bytes(std::span{mesh->vertices}), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT),
+            stage(std::as_bytes(std::span{mesh->indices}), VK_BUFFER_USAGE_INDEX_BUFFER_BIT),
+            static_cast<uint32_t>(mesh->indices.size()),
+            mesh->pos
+        });
+    }
+    pending_uploads_.erase(pending_uploads_.begin(), pending_uploads_.begin() + upload_count);
+}
+
+void Renderer::draw(RenderData const& render_data) 
+{
+    PROFILE_SCOPE("draw");
     auto& frame = current_frame();
-    frame.cmd.wait();
+    {
+        PROFILE_SCOPE("wait_frame");
+        frame.cmd.wait();
+    }
+    // Whatever was retired or staged while this frame slot was last in use is no longer referenced by the GPU
+    retired_[frame_number_ % FRAME_OVERLAP].clear();
+    uploads_[frame_number_ % FRAME_OVERLAP].clear();
+    take_gpu_times();
     handle_world_data(render_data);
+    sync_meshes(render_data.updates, render_data.player_pos);
     auto const swapchain_index = acquire_image();
-    if (not swapchain_index.has_value()) return;
 
-    record(*swapchain_index, count, index, vertex);
-    submit();
-    present(*swapchain_index);
+    // Submitted even without an image, the staged uploads have to happen and the fence has to signal again
+    record(swapchain_index, render_data.visible);
+    submit(swapchain_index.has_value());
+    if (swapchain_index.has_value()) present(*swapchain_index);
     ++frame_number_;
 }
 
-void Renderer::record(uint32_t const swapchain_index, uint32_t const index_count, GpuBuffer const& indicies, GpuBuffer const& verticies)
+void Renderer::record(std::optional<uint32_t> const swapchain_index, std::span<MeshHandle const> visible)
 {
+    PROFILE_SCOPE("record");
     auto& frame = current_frame();
     frame.cmd.record([&](VkCommandBuffer cmd) {
-        auto begin_info = render_pass_begin_info(render_pass_, frame_buffers_.at(swapchain_index), extent_);
-        vkCmdBeginRenderPass(cmd, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, main_pipeline_.pipeline);
-        vkCmdSetViewport(cmd, 0, 1, &viewport_.viewport);
-        vkCmdSetScissor(cmd, 0, 1, &viewport_.scissors);
-        VkDeviceSize offset{0};
-        vkCmdBindVertexBuffers(cmd, 0, 1, &verticies.handle(), &offset);
-        vkCmdBindIndexBuffer(cmd, indicies.handle(), 0, VK_INDEX_TYPE_UINT16);
-        
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, main_pipeline_.layout, 0, 1, &frame.unfirom_descriptor, 0, nullptr);
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, main_pipeline_.layout, 1, 1, &frame.texture_descriptor, 0, nullptr);
-
-        vkCmdDrawIndexed(cmd, index_count, 1, 0, 0, 0);
-        vkCmdEndRenderPass(cmd);
+        frame.timestamps.reset(cmd);
+        frame.timestamps.write(cmd, FrameTimestamps::UploadsBegin);
+        record_uploads(cmd);
+        frame.timestamps.write(cmd, FrameTimestamps::UploadsEnd);
+
+        frame.timestamps.write(cmd, FrameTimestamps::PassBegin);
+        if (swapchain_index.has_value()) record_pass(cmd, *swapchain_index, visible);
+        frame.timestamps.write(cmd, FrameTimestamps::PassEnd);
     });
 }
 
-void Renderer::submit()
+void Renderer::record_pass(VkCommandBuffer const cmd, uint32_t const swapchain_index, std::span<MeshHandle const> visible)
 {
+    auto& frame = current_frame();
+    auto begin_info = render_pass_begin_info(render_pass_, frame_buffers_.at(swapchain_index), extent_);
+    vkCmdBeginRenderPass(cmd, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, main_pipeline_.pipeline);
+    vkCmdSetViewport(cmd, 0, 1, &viewport_.viewport);
+    vkCmdSetScissor(cmd, 0, 1, &viewport_.scissors);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, main_pipeline_.layout, 0, 1, &frame.unfirom_descriptor, 0, nullptr);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, main_pipeline_.layout, 1, 1, &frame.texture_descriptor, 0, nullptr);
+
+    for (auto const handle : visible)
+    {
+        if (handle >= meshes_.size() or not meshes_[handle].gpu.has_value()) continue;
+        auto const& mesh = *meshes_[handle].gpu;
+        ChunkConstants const constants {
+            .origin = {static_cast<float>(mesh.pos.x * SECTION_SIZE), 0.f, static_cast<float>(mesh.pos.z * SECTION_SIZE), 0.f},
+        };
+        vkCmdPushConstants(cmd, main_pipeline_.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+        VkDeviceSize offset{0};
+        vkCmdBindVertexBuffers(cmd, 0, 1, &mesh.vertices.handle(), &offset);
+        vkCmdBindIndexBuffer(cmd, mesh.indices.handle(), 0, VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexed(cmd, mesh.index_count, 1, 0, 0, 0);
+    }
+    vkCmdEndRenderPass(cmd);
+}
+
+void Renderer::submit(bool const presenting)
+{
+    PROFILE_SCOPE("submit");
     auto& frame = current_frame();
     VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
     VkSubmitInfo submit_info
     {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
         .pNext = nullptr,
-        .waitSemaphoreCount = 1,
+        .waitSemaphoreCount = presenting ? 1u : 0u,
         .pWaitSemaphores = &frame.image_acquired.handle(),
         .pWaitDstStageMask = wait_stages,
         .commandBufferCount = 1,
         .pCommandBuffers = &frame.cmd.buffer(),
-        .signalSemaphoreCount = 1,
+        .signalSemaphoreCount = presenting ? 1u : 0u,
         .pSignalSemaphores = &frame.image_rendered.handle()
     };
     assert(!frame.cmd.execution_fence().is_signaled());
@@ -474,6 +593,7 @@ void Renderer::submit()
 
 void Renderer::present(uint32_t const& swapchain_index)
 {
+    PROFILE_SCOPE("present");
     auto& frame = current_frame();
     VkPresentInfoKHR present_info
     {
@@ -1,5 +1,8 @@
 #pragma once
+#include <optional>
+#include <span>
 #include "interfaces.hpp"
+#include "loop_timer.hpp"
 #include "device.hpp"
 #include "window.hpp"
 #include "swapchain.hpp"
@@ -23,8 +26,58 @@ public:
     ~Renderer();
 
     void draw(RenderData const& render_data);
+
+    // Changed chunk meshes still waiting for their turn to be uploaded
+    [[nodiscard]] size_t pending_uploads() const
+    {
+        return pending_uploads_.size();
+    }
+
+    // GPU time per frame, of the frames read back since the last take(). They are read FRAME_OVERLAP frames late
+    [[nodiscard]] LoopTimer& gpu_timer()
+    {
+        return gpu_timer_;
+    }
+
+    // Of the newest frame read back
+    [[nodiscard]] GpuFrameTimes const& gpu_times() const
+    {
+        return gpu_times_;
+    }
 private:
+    // Every upload is a staging buffer and a copy at the start of the frame, more than a handful per frame shows up as a hitch
+    static constexpr size_t MAX_UPLOADS_PER_FRAME {8};
+
+    struct GpuMesh
+    {
+        GpuBuffer vertices;
+        GpuBuffer indices;
+        uint32_t index_count;
+        ChunkPos pos;
+    };
+
+    // What the renderer has of one mesh handle
+    struct MeshSlot
+    {
+        std::optional<GpuMesh> gpu;
+        // Newer than what's on the GPU, waiting for its turn to be uploaded
+        std::shared_ptr<ChunkMesh const> pending;
+        bool queued{false};
+    };
+
+    // Copied into target by the frame that staged it, before its render pass
+    struct StagedCopy
+    {
+        GpuBuffer staging;
+        VkBuffer target;
+    };
+
     void handle_world_data(RenderData const& data);
+    void sync_meshes(std::span<MeshUpdate const> updates, glm::vec3 const& viewer);
+    void retire(GpuMesh&& mesh);
+    [[nodiscard]] GpuBuffer stage(std::span<std::byte const> data, VkBufferUsageFlags const usage);
+    void record_uploads(VkCommandBuffer const cmd);
+    void take_gpu_times();
 
     [[nodiscard]] Framedata& current_frame()
     {
@@ -37,8 +90,10 @@ private:
     }
     
     std::optional<uint32_t> acquire_image();
-    void record(uint32_t const swapchain_index, uint32_t const index_count, GpuBuffer const& indicies, GpuBuffer const& verticies);
-    void submit();
+    // Without an image the frame only uploads
+    void record(std::optional<uint32_t> const swapchain_index, std::span<MeshHandle const> visible);
+    void record_pass(VkCommandBuffer const cmd, uint32_t const swapchain_index, std::span<MeshHandle const> visible);
+    void submit(bool const presenting);
     void present(uint32_t const& swapchain_index);
 
     Window& window_;
@@ -63,6 +118,17 @@ private:
     std::vector<VkFramebuffer> frame_buffers_;
     Texture texture_;
     Frames frames_;
+    // Indexed by mesh handle, a mirror of the world's meshes
+    std::vector<MeshSlot> meshes_;
+    // Sequence of the last mesh update taken
+    uint64_t mesh_sequence_{0};
+    // Meshes replaced during a frame, freed once the GPU can no longer be using them
+    std::array<std::vector<GpuMesh>, FRAME_OVERLAP> retired_;
+    // Per frame slot, staging buffers live until the slot's fence says the copies are done
+    std::array<std::vector<StagedCopy>, FRAME_OVERLAP> uploads_;
+    std::vector<MeshHandle> pending_uploads_;
+    LoopTimer gpu_timer_;
+    GpuFrameTimes gpu_times_{};
 
     size_t frame_number_{};
 };
@@ -0,0 +1,70 @@
+#include <array>
+#include <vector>
+#include "timestamps.hpp"
+#include "device.hpp"
+#include "queues.hpp"
+
+FrameTimestamps::FrameTimestamps(Device const& device, VkSurfaceKHR const surface) :
+    device_{device}
+{
+    uint32_t family_count{};
+    vkGetPhysicalDeviceQueueFamilyProperties(device.physical(), &family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(device.physical(), &family_count, families.data());
+    auto const valid_bits = families.at(QueueFamily{device.physical(), surface}.id()).timestampValidBits;
+    if (valid_bits == 0) return;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device.physical(), &properties);
+    period_ = properties.limits.timestampPeriod;
+    valid_mask_ = valid_bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << valid_bits) - 1;
+
+    VkQueryPoolCreateInfo info
+    {
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .queryType = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = MARKER_COUNT,
+        .pipelineStatistics = 0
+    };
+    utils::check_vk(vkCreateQueryPool(device.logical(), &info, nullptr, &pool_));
+}
+
+FrameTimestamps::~FrameTimestamps()
+{
+    if (pool_ != VK_NULL_HANDLE) vkDestroyQueryPool(device_.logical(), pool_, nullptr);
+}
+
+void FrameTimestamps::reset(VkCommandBuffer const cmd)
+{
+    if (pool_ == VK_NULL_HANDLE) return;
+    vkCmdResetQueryPool(cmd, pool_, 0, MARKER_COUNT);
+    pending_ = true;
+}
+
+void FrameTimestamps::write(VkCommandBuffer const cmd, Marker const marker)
+{
+    if (pool_ == VK_NULL_HANDLE) return;
+    // Begin markers as soon as the commands before them started, end markers once they're all done
+    auto const stage = marker == UploadsBegin or marker == PassBegin ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    vkCmdWriteTimestamp(cmd, stage, pool_, marker);
+}
+
+std::optional<GpuFrameTimes> FrameTimestamps::read()
+{
+    if (not pending_) return std::nullopt;
+
+    // Without the wait bit this returns VK_NOT_READY instead of blocking until all of them are available
+    std::array<uint64_t, MARKER_COUNT> ticks{};
+    auto const result = vkGetQueryPoolResults(
+        device_.logical(), pool_, 0, MARKER_COUNT, sizeof(ticks), ticks.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result == VK_NOT_READY) return std::nullopt;
+    utils::check_vk(result);
+    pending_ = false;
+
+    auto const milliseconds = [&](Marker const from, Marker const to) {
+        return static_cast<double>((ticks[to] - ticks[from]) & valid_mask_) * period_ / 1e6;
+    };
+    return GpuFrameTimes{milliseconds(UploadsBegin, UploadsEnd), milliseconds(PassBegin, PassEnd), milliseconds(UploadsBegin, PassEnd)};
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <optional>
+#include "utils.hpp"
+
+class Device;
+
+// What the GPU spent on one frame, in milliseconds
+struct GpuFrameTimes
+{
+    double uploads;
+    double pass;
+    double frame;
+};
+
+// Timestamps one frame slot's command buffer writes around its uploads and its render pass. Reading them back never
+// waits, results the GPU hasn't got to yet are simply tried again later.
+// Queues that can't write timestamps get no pool, their frames never have results
+class FrameTimestamps
+{
+public:
+    enum Marker : uint32_t
+    {
+        UploadsBegin,
+        UploadsEnd,
+        PassBegin,
+        PassEnd,
+        MARKER_COUNT
+    };
+
+    FrameTimestamps(Device const& device, VkSurfaceKHR const surface);
+
+    FrameTimestamps(FrameTimestamps const&) = delete;
+    FrameTimestamps& operator=(FrameTimestamps const&) = delete;
+    ~FrameTimestamps();
+
+    // Before the first marker of a frame, outside of render passes
+    void reset(VkCommandBuffer const cmd);
+    void write(VkCommandBuffer const cmd, Marker const marker);
+    // Once per recorded frame, nothing until the GPU is done with it
+    [[nodiscard]] std::optional<GpuFrameTimes> read();
+
+    [[nodiscard]] bool supported() const
+    {
+        return pool_ != VK_NULL_HANDLE;
+    }
+
+private:
+    Device const& device_;
+    VkQueryPool pool_{VK_NULL_HANDLE};
+    // Nanoseconds per timestamp tick
+    double period_{0.};
+    // Of the bits the queue writes, timestamps wrap around within them
+    uint64_t valid_mask_{0};
+    // Recorded and not read back yet
+    bool pending_{false};
+};
@@ -7,3 +7,8 @@ struct UniformBufferObject {
     glm::mat4 projection;
 };
 
+
+// Per draw, where the chunk being drawn sits in the world
+struct ChunkConstants {
+    glm::vec4 origin;
+};
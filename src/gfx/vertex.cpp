@@ -4,26 +4,27 @@ namespace
 {
 constexpr Descriptions default_descriptors
 {
-    .attribute = {
-        .position = {
+    .attributes = {{
+        {
             .location = 0,
             .binding = 0,
             .format = VK_FORMAT_R32G32B32_SFLOAT,
             .offset = offsetof(Vertex, pos),
         },
-        .color = {
+        {
             .location = 1,
             .binding = 0,
             .format = VK_FORMAT_R32G32B32_SFLOAT,
             .offset = offsetof(Vertex, color),
         },
-        .uv = {
+        {
             .location = 2,
             .binding = 0,
             .format = VK_FORMAT_R32G32_SFLOAT,
             .offset = offsetof(Vertex, uv)
         }
-    },
+    }},
+    .attribute_count = 3,
     .binding = {
         .binding = 0,
         .stride = sizeof(Vertex),
@@ -31,6 +32,30 @@ constexpr Descriptions default_descriptors
     }
 };
 
+constexpr Descriptions packed_descriptors
+{
+    .attributes = {{
+        {
+            .location = 0,
+            .binding = 0,
+            .format = VK_FORMAT_R32_UINT,
+            .offset = offsetof(PackedVertex, position),
+        },
+        {
+            .location = 1,
+            .binding = 0,
+            .format = VK_FORMAT_R32_UINT,
+            .offset = offsetof(PackedVertex, attributes),
+        }
+    }},
+    .attribute_count = 2,
+    .binding = {
+        .binding = 0,
+        .stride = sizeof(PackedVertex),
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+    }
+};
+
 } // namespace
 
 Descriptions Vertex::descriptions()
@@ -38,3 +63,7 @@ Descriptions Vertex::descriptions()
     return default_descriptors;
 }
 
+Descriptions PackedVertex::descriptions()
+{
+    return packed_descriptors;
+}
@@ -1,23 +1,49 @@
 #pragma once
+#include <array>
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
 
 
 struct Descriptions {
-    struct Attribiute {
-        VkVertexInputAttributeDescription position;
-        VkVertexInputAttributeDescription color;
-        VkVertexInputAttributeDescription uv;
-    } attribute;
+    static constexpr size_t MAX_ATTRIBUTES {4};
+
+    std::array<VkVertexInputAttributeDescription, MAX_ATTRIBUTES> attributes;
+    uint32_t attribute_count;
     VkVertexInputBindingDescription binding;
 };
 
+// Full precision vertex, handy for debug geometry
 struct Vertex {
     glm::vec3 pos;
     glm::vec3 color;
     glm::vec2 uv;
     
     static Descriptions descriptions();
-    static constexpr uint8_t COUNT {3};
 };
 
+// Chunk geometry, 8 bytes per vertex. Position is local to the chunk, the vertex shader
+// adds the chunk origin from a push constant. Decoded in cube.vert, keep the two in sync.
+struct PackedVertex {
+    // x: 5 bits, y: 9 bits, z: 5 bits, face: 3 bits
+    uint32_t position;
+    // texture layer: 8 bits, ambient occlusion: 2 bits, sky light: 4 bits, block light: 4 bits
+    uint32_t attributes;
+
+    static constexpr PackedVertex pack(
+        glm::uvec3 const pos,
+        uint32_t const face,
+        uint32_t const layer,
+        uint32_t const ao,
+        uint32_t const sky_light,
+        uint32_t const block_light)
+    {
+        return {
+            (pos.x & 31u) | ((pos.y & 511u) << 5) | ((pos.z & 31u) << 14) | ((face & 7u) << 19),
+            (layer & 255u) | ((ao & 3u) << 8) | ((sky_light & 15u) << 10) | ((block_light & 15u) << 14),
+        };
+    }
+
+    static Descriptions descriptions();
+};
+
+static_assert(sizeof(PackedVertex) == 8);
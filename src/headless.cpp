@@ -0,0 +1,196 @@
+#include "headless.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "log.hpp"
+#include "recording.hpp"
+#include "utils.hpp"
+#include "world.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Only the projection depends on it, ticks never look at that
+constexpr glm::uvec2 EXTENT {800, 600};
+
+// The bench path: a wide curve well above the terrain, about as fast as a flying player goes
+constexpr float TICKS_PER_SECOND {480.f};
+constexpr float PATH_SECONDS {20.f};
+constexpr float FLY_SPEED {20.f};
+constexpr float FLY_HEIGHT {110.f};
+// Radians per second
+constexpr float TURN_RATE {0.15f};
+// Camera turn per tick while flying
+constexpr glm::vec2 LOOK_AROUND {0.05f, 0.f};
+constexpr auto SETTLE_TIMEOUT {std::chrono::seconds{30}};
+
+[[nodiscard]] bool streaming_busy(StreamingStats const& stats)
+{
+    return stats.waiting_for_generation + stats.waiting_for_mesh + stats.waiting_for_light + stats.generating + stats.stitching + stats.meshing > 0;
+}
+
+// Nearest rank percentiles, as a JSON object
+template <typename T>
+[[nodiscard]] std::string summary(std::vector<T> samples)
+{
+    if (samples.empty()) return R"({"count": 0})";
+    std::sort(samples.begin(), samples.end());
+    auto const percentile = [&](double const fraction) {
+        auto const rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(samples.size())));
+        return static_cast<double>(samples[std::max<size_t>(rank, 1) - 1]);
+    };
+    return fmt::format(R"({{"count": {}, "p50_ms": {:.4f}, "p99_ms": {:.4f}, "max_ms": {:.4f}}})",
+        samples.size(), percentile(0.5), percentile(0.99), static_cast<double>(samples.back()));
+}
+
+} // namespace
+
+int replay(std::filesystem::path const& path)
+{
+    InputReplay recording{path};
+    auto const directory = std::filesystem::temp_directory_path() / "minecraft2-replay";
+    std::filesystem::remove_all(directory);
+
+    uint64_t ticks{};
+    uint64_t checksum{};
+    double seconds{};
+    {
+        JobSystem jobs{std::max(std::thread::hardware_concurrency(), 2u)};
+        World world{jobs, EXTENT, recording.time_per_tick(), directory};
+        world.set_lockstep(true);
+
+        auto const start = Clock::now();
+        while (recording.ticks() > 0 ? ticks < recording.ticks() : not recording.done())
+        {
+            world.tick(recording.next());
+            ++ticks;
+        }
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        checksum = world.checksum();
+    }
+    std::filesystem::remove_all(directory);
+
+    info("Replayed {} ticks in {:.2f} s, {:.0f} ticks/s", ticks, seconds, static_cast<double>(ticks) / seconds);
+    if (recording.ticks() == 0)
+    {
+        info("World checksum {:016x}, the recording has no end to compare it with", checksum);
+        return 0;
+    }
+    if (checksum != recording.checksum())
+    {
+        error("World checksum {:016x} doesn't match the recorded {:016x}", checksum, recording.checksum());
+        return 1;
+    }
+    info("World checksum {:016x} matches the recording", checksum);
+    return 0;
+}
+
+int headless_bench(std::filesystem::path const& output)
+{
+    auto const directory = std::filesystem::temp_directory_path() / "minecraft2-headless-bench";
+    std::filesystem::remove_all(directory);
+
+    auto const path_ticks = static_cast<size_t>(PATH_SECONDS * TICKS_PER_SECOND);
+    std::vector<double> ticks;
+    std::vector<double> player;
+    std::vector<double> streaming;
+    std::vector<double> writeback;
+    std::vector<double> snapshots;
+    for (auto* samples : {&ticks, &player, &streaming, &writeback, &snapshots})
+    {
+        samples->reserve(path_ticks * 2);
+    }
+    JobTimes job_times;
+    StreamingStats stats;
+    double settle_seconds{};
+    {
+        JobSystem jobs{std::max(std::thread::hardware_concurrency(), 2u)};
+        StreamingSettings settings;
+        settings.time_jobs = true;
+        World world{jobs, EXTENT, 1.f / TICKS_PER_SECOND, directory, settings};
+        auto snapshot = world.to_render();
+        UserInput input;
+
+        auto const tick_length = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>{1.f / TICKS_PER_SECOND});
+        auto next_tick = Clock::now();
+        // Paced like the simulation thread, streaming jobs get the wall time they would get in the game
+        auto const tick = [&](glm::vec3 const& position) {
+            world.place_player(position);
+            auto const start = Clock::now();
+            world.tick(input);
+            auto const ticked = Clock::now();
+            world.to_render(snapshot, snapshot.sequence);
+            auto const end = Clock::now();
+
+            ticks.push_back(std::chrono::duration<double, std::milli>(ticked - start).count());
+            snapshots.push_back(std::chrono::duration<double, std::milli>(end - ticked).count());
+            player.push_back(world.tick_timings().player);
+            streaming.push_back(world.tick_timings().streaming);
+            writeback.push_back(world.tick_timings().writeback);
+
+            next_tick += tick_length;
+            std::this_thread::sleep_until(next_tick);
+        };
+
+        glm::vec3 position {8.f, FLY_HEIGHT, 8.f};
+        input.mouse_delta = LOOK_AROUND;
+        for (size_t idx{}; idx < path_ticks; ++idx)
+        {
+            auto const heading = TURN_RATE * static_cast<float>(idx) / TICKS_PER_SECOND;
+            position += glm::vec3{std::cos(heading), 0.f, std::sin(heading)} * (FLY_SPEED / TICKS_PER_SECOND);
+            tick(position);
+        }
+
+        input.mouse_delta = {0.f, 0.f};
+        auto const settle_start = Clock::now();
+        while (streaming_busy(world.streaming_stats()) and Clock::now() - settle_start < SETTLE_TIMEOUT)
+        {
+            tick(position);
+        }
+        settle_seconds = std::chrono::duration<double>(Clock::now() - settle_start).count();
+        job_times = world.job_times();
+        stats = world.streaming_stats();
+    }
+    std::filesystem::remove_all(directory);
+
+    auto const json = fmt::format(
+        "{{\n"
+        "  \"path_seconds\": {:.1f},\n"
+        "  \"settle_seconds\": {:.3f},\n"
+        "  \"ticks\": {},\n"
+        "  \"chunks_loaded\": {},\n"
+        "  \"chunks_meshed\": {},\n"
+        "  \"stages\": {{\n"
+        "    \"tick\": {},\n"
+        "    \"player\": {},\n"
+        "    \"streaming\": {},\n"
+        "    \"writeback\": {},\n"
+        "    \"snapshot\": {},\n"
+        "    \"generate_job\": {},\n"
+        "    \"stitch_job\": {},\n"
+        "    \"mesh_job\": {}\n"
+        "  }}\n"
+        "}}\n",
+        PATH_SECONDS, settle_seconds, ticks.size(), stats.loaded, stats.meshed,
+        summary(ticks), summary(player), summary(streaming), summary(writeback), summary(snapshots),
+        summary(job_times.generate), summary(job_times.stitch), summary(job_times.mesh));
+
+    if (output.empty())
+    {
+        // After everything logged so far, the logger writes to stdout too
+        logging::flush();
+        fmt::print("{}", json);
+        return 0;
+    }
+    std::ofstream file {output};
+    file << json;
+    if (not file) fail("Can't write {}", output.string());
+    info("Wrote {}", output.string());
+    return 0;
+}
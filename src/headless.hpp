@@ -0,0 +1,14 @@
+#pragma once
+#include <filesystem>
+
+// Modes that run the world without a window or a GPU, each returns the exit code of the process
+
+// Plays a recorded session back into a lockstep world generated from scratch in a temporary directory, then
+// compares the world's checksum with the recorded one. A session that loaded edited chunks from its save
+// won't match
+int replay(std::filesystem::path const& path);
+
+// Flies the player along a fixed path over terrain generated from scratch, ticking at the game's rate, then
+// stands until streaming has caught up. Writes p50, p99 and max of every tick stage and every kind of chunk job
+// as JSON to output, stdout when it's empty
+int headless_bench(std::filesystem::path const& output);
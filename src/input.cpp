@@ -34,9 +34,12 @@ InputCollector::InputCollector(GLFWwindow* window):
     }()},
     mouse_{window}
 {
-    glfwSetWindowUserPointer(window, (void*)this);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetKeyCallback(window, key_callback);
+    if (window != nullptr)
+    {
+        glfwSetWindowUserPointer(window, (void*)this);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetKeyCallback(window, key_callback);
+    }
     debug("InputCollector initalized");
 }
 
@@ -59,14 +62,18 @@ void InputCollector::key_callback(
     int key_action,
     [[maybe_unused]] int mods) 
 {
-    auto self = static_cast<InputCollector*>(glfwGetWindowUserPointer(window));
-    if (static_cast<size_t>(key) > self->keys_.size()) 
+    static_cast<InputCollector*>(glfwGetWindowUserPointer(window))->key_event(key, key_action);
+}
+
+void InputCollector::key_event(int key, int key_action)
+{
+    if (static_cast<size_t>(key) >= keys_.size()) 
     {
         warn("Unkown key value: {}", key);
         return;
     }
 
-    auto& own_key = self->keys_.at(key);
+    auto& own_key = keys_.at(key);
     switch (key_action) {
         case GLFW_RELEASE:
             own_key.state = Key::Inactive;
@@ -80,15 +87,18 @@ void InputCollector::key_callback(
 }
 
 void InputCollector::mouse_callback(GLFWwindow* window, double x_pos, double y_pos) {
-    auto self = static_cast<InputCollector*>(glfwGetWindowUserPointer(window));
-    glm::vec2 const new_pos {x_pos, y_pos};
-    self->mouse_.delta() = glm::clamp(new_pos - self->mouse_.position(), -100.f, 100.0f);
-    self->mouse_.position() = new_pos;
+    static_cast<InputCollector*>(glfwGetWindowUserPointer(window))->mouse_event({x_pos, y_pos});
+}
+
+void InputCollector::mouse_event(glm::vec2 const& position)
+{
+    mouse_.delta() = glm::clamp(position - mouse_.position(), -100.f, 100.0f);
+    mouse_.position() = position;
 }
 
-UserInput InputCollector::actions() const
+void InputCollector::actions(UserInput& input) const
 {
-    UserInput input;
+    input.user_actions.clear();
     input.mouse_delta = mouse_.delta();
     input.mouse_position = mouse_.position();
     for (auto& key : keys_) 
@@ -97,5 +107,4 @@ UserInput InputCollector::actions() const
         if (action_it == action_mappings_.end()) continue;
         input.user_actions.emplace_back(action_it->second);
     }
-    return input;
 }
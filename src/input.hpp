@@ -2,8 +2,8 @@
 #include <GLFW/glfw3.h>
 #include <map>
 #include <vector>
-#include "utils.hpp"
 #include "interfaces.hpp"
+#include "utils.hpp"
 
 
 struct Key 
@@ -51,9 +51,14 @@ private:
 class InputCollector 
 {
 public:
+    // Without a window nothing gets registered and events only come in by hand, like the benchmarks do
     InputCollector(GLFWwindow* window);
     void update();
-    UserInput actions() const;
+    // Refills input, reusing its memory
+    void actions(UserInput& input) const;
+
+    void key_event(int key, int key_action);
+    void mouse_event(glm::vec2 const& position);
 private:
     static void key_callback(GLFWwindow* window, int key, [[maybe_unused]] int scancode, int key_action, [[maybe_unused]] int mods);
     static void mouse_callback(GLFWwindow* window, double x_pos, double y_pos);
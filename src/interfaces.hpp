@@ -1,7 +1,8 @@
 #pragma once
+#include <memory>
 #include <vector>
 #include "camera.hpp"
-#include "gfx/vertex.hpp"
+#include "voxel/mesher.hpp"
 
 enum class Action {
     Left,
@@ -18,18 +19,33 @@ enum class Action {
 struct UserInput
 {
     std::vector<Action> user_actions;
-    glm::vec2 mouse_delta;
-    glm::vec2 mouse_position;
+    glm::vec2 mouse_delta{0.f};
+    glm::vec2 mouse_position{0.f};
 };
 
 
-// World -> renderer
+// A chunk mesh the renderer has to replace or drop
+struct MeshUpdate
+{
+    // Numbers every update the world ever made, in order
+    uint64_t sequence;
+    MeshHandle handle;
+    // Shared with the world, which never changes a mesh once it is published. Null when the handle was freed
+    std::shared_ptr<ChunkMesh const> mesh;
+};
+
+// World -> renderer. Mirrored meshes are referred to by handle, only changes carry geometry, and the world
+// refills the same few snapshots over and over so handing one over doesn't allocate once they have grown
 struct RenderData 
 {
     PerspectiveCamera camera;
     glm::vec3 player_pos;
-    // This shouldn't be a dynamic allocated container
-    std::vector<Vertex> vertices;
-    std::vector<uint16_t> indices;
+    // Meshes in view of the camera, the ones to draw
+    std::vector<MeshHandle> visible;
+    // Every update the renderer hasn't acknowledged yet, oldest first. Snapshots repeat them until it does,
+    // updates it has already seen are skipped by their sequence
+    std::vector<MeshUpdate> updates;
+    // Of the last update up to this snapshot, what the renderer acknowledges once it has taken them
+    uint64_t sequence{0};
 };
 
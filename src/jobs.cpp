@@ -0,0 +1,99 @@
+#include "jobs.hpp"
+#include <string>
+#include "profiler.hpp"
+
+thread_local JobSystem const* JobSystem::current_system_ {nullptr};
+thread_local size_t JobSystem::current_index_ {0};
+
+JobSystem::JobSystem(size_t const thread_count) :
+    queues_(std::max<size_t>(thread_count, 1))
+{
+    workers_.reserve(queues_.size() - 1);
+    for (size_t idx{1}; idx < queues_.size(); ++idx)
+    {
+        workers_.emplace_back([this, idx] { work(idx); });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    stopping_.store(true);
+    // Wakes up sleeping workers, they see stopping_ before looking for work
+    queued_.fetch_add(1);
+    queued_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(Job const& job, JobCounter& counter)
+{
+    counter.fetch_add(1, std::memory_order_relaxed);
+    auto& queue = queues_[thread_index()];
+    {
+        std::lock_guard lock{queue.mutex};
+        queue.tasks.push_back({job, &counter});
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+    queued_.notify_one();
+}
+
+void JobSystem::wait(JobCounter const& counter)
+{
+    auto const index = thread_index();
+    while (counter.load(std::memory_order_acquire) > 0)
+    {
+        // Whatever is left is already running on other threads
+        if (not run_one(index)) std::this_thread::yield();
+    }
+}
+
+void JobSystem::work(size_t const index)
+{
+    current_system_ = this;
+    current_index_ = index;
+    profiler::name_thread("worker " + std::to_string(index));
+
+    while (not stopping_.load(std::memory_order_relaxed))
+    {
+        if (run_one(index)) continue;
+        queued_.wait(0, std::memory_order_acquire);
+    }
+}
+
+bool JobSystem::run_one(size_t const index)
+{
+    Task task;
+    if (not pop(index, task) and not steal(index, task)) return false;
+
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    task.job();
+    task.counter->fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+bool JobSystem::pop(size_t const index, Task& task)
+{
+    auto& queue = queues_[index];
+    std::lock_guard lock{queue.mutex};
+    if (queue.tasks.empty()) return false;
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool JobSystem::steal(size_t const index, Task& task)
+{
+    // Victims in round robin order starting after ourselves, so thieves spread over different deques
+    for (size_t offset{1}; offset < queues_.size(); ++offset)
+    {
+        auto& queue = queues_[(index + offset) % queues_.size()];
+        std::lock_guard lock{queue.mutex};
+        if (queue.tasks.empty()) continue;
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
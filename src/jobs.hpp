@@ -0,0 +1,128 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Callable stored inline, wrapping one in a Job never allocates. The worker deques still allocate a block now and
+// then as they grow.
+// Anything trivially copyable that fits works, in practice lambdas capturing a few pointers or indices.
+class Job
+{
+public:
+    Job() = default;
+
+    template <typename Func>
+    Job(Func const& func) :
+        run_{[](void const* data) { (*std::launder(static_cast<Func const*>(data)))(); }}
+    {
+        static_assert(sizeof(Func) <= STORAGE_SIZE, "Job captures too much, capture a pointer to the state instead");
+        static_assert(alignof(Func) <= alignof(std::max_align_t));
+        static_assert(std::is_trivially_copyable_v<Func>);
+        new (storage_.data()) Func(func);
+    }
+
+    void operator()() const
+    {
+        run_(storage_.data());
+    }
+
+private:
+    static constexpr size_t STORAGE_SIZE {48};
+
+    void (*run_)(void const*) {nullptr};
+    alignas(std::max_align_t) std::array<std::byte, STORAGE_SIZE> storage_{};
+};
+
+// Counts jobs that have been submitted against it and have not finished yet
+using JobCounter = std::atomic<uint32_t>;
+
+// Work stealing thread pool.
+// Every thread owns a deque: it pushes and pops its own jobs at the back (newest first, still warm in cache),
+// idle threads steal from the front of the others (oldest first, usually the biggest remaining chunk of work).
+// The thread creating the system is thread 0 and has a deque too, it runs jobs while it waits on a counter
+// instead of blocking. Only thread 0 and the workers may submit or wait, another thread has to take_over() first.
+// Jobs are chunk sized, tens of microseconds and up, so a mutex per deque is never contended enough to matter.
+class JobSystem
+{
+public:
+    // Thread count includes the calling thread, 1 runs every job inline in wait()
+    explicit JobSystem(size_t const thread_count = std::max(std::thread::hardware_concurrency(), 1u));
+    ~JobSystem();
+
+    JobSystem(JobSystem const&) = delete;
+    JobSystem& operator=(JobSystem const&) = delete;
+
+    // Makes the calling thread thread 0, for handing the work that drives the jobs to a thread of its own. The
+    // previous thread 0 may not submit or wait from then on, until it takes over again once the other thread is done
+    void take_over()
+    {
+        owner_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    }
+
+    void submit(Job const& job, JobCounter& counter);
+    // Runs queued jobs, from any thread's deque, until the counter drops to zero
+    void wait(JobCounter const& counter);
+
+    // Runs func(idx) for every idx in [0, count) and waits for all of them
+    template <typename Func>
+    void parallel_for(size_t const count, Func const& func)
+    {
+        JobCounter counter{0};
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            submit([&func, idx] { func(idx); }, counter);
+        }
+        wait(counter);
+    }
+
+    [[nodiscard]] size_t thread_count() const
+    {
+        return queues_.size();
+    }
+
+    // Index of the calling thread in [0, thread_count), for per-thread scratch memory like meshers
+    [[nodiscard]] size_t thread_index() const
+    {
+        if (current_system_ == this) return current_index_;
+        assert(owner_.load(std::memory_order_relaxed) == std::this_thread::get_id() and "Only thread 0 and the workers may use a JobSystem");
+        return 0;
+    }
+
+private:
+    struct Task
+    {
+        Job job;
+        JobCounter* counter{nullptr};
+    };
+
+    struct alignas(64) Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void work(size_t const index);
+    bool run_one(size_t const index);
+    bool pop(size_t const index, Task& task);
+    bool steal(size_t const index, Task& task);
+
+    // Set on the workers only
+    static thread_local JobSystem const* current_system_;
+    static thread_local size_t current_index_;
+
+    std::vector<Queue> queues_;
+    std::vector<std::thread> workers_;
+    // Thread 0, the workers know their index from current_index_
+    std::atomic<std::thread::id> owner_{std::this_thread::get_id()};
+    // Jobs sitting in any deque, idle workers sleep on it
+    alignas(64) std::atomic<uint32_t> queued_{0};
+    std::atomic<bool> stopping_{false};
+};
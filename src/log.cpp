@@ -0,0 +1,178 @@
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include "log.hpp"
+
+namespace
+{
+
+// Power of two, positions map to slots by their low bits
+constexpr size_t QUEUE_SIZE {1024};
+
+// Bounded multi producer queue after Vyukov: a slot's sequence says whose turn it is. It equals the position of the
+// producer that may claim it, one more once that one has published it, and QUEUE_SIZE more once the logging thread
+// has written it and it is free for the next round
+struct Slot
+{
+    std::atomic<uint64_t> sequence;
+    logging::Record record;
+};
+
+class Logger
+{
+public:
+    Logger()
+    {
+        for (uint64_t idx{}; idx < QUEUE_SIZE; ++idx)
+        {
+            slots_[idx].sequence.store(idx, std::memory_order_relaxed);
+        }
+        thread_ = std::thread{[this] { run(); }};
+    }
+
+    ~Logger()
+    {
+        stopping_.store(true, std::memory_order_release);
+        published_.fetch_add(1, std::memory_order_release);
+        published_.notify_one();
+        thread_.join();
+    }
+
+    logging::Record* claim()
+    {
+        auto position = enqueue_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& slot = slots_[position % QUEUE_SIZE];
+            auto const sequence = slot.sequence.load(std::memory_order_acquire);
+            auto const lag = static_cast<int64_t>(sequence - position);
+            if (lag == 0)
+            {
+                if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.record.position = position;
+                    return &slot.record;
+                }
+            }
+            else if (lag < 0)
+            {
+                // Still taken from the previous round, the logging thread is a whole queue behind
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            else
+            {
+                position = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(logging::Record const& record)
+    {
+        slots_[record.position % QUEUE_SIZE].sequence.store(record.position + 1, std::memory_order_release);
+        published_.fetch_add(1, std::memory_order_release);
+        published_.notify_one();
+    }
+
+    void wait_written(uint64_t const position)
+    {
+        auto written = written_.load(std::memory_order_acquire);
+        while (written <= position)
+        {
+            written_.wait(written, std::memory_order_acquire);
+            written = written_.load(std::memory_order_acquire);
+        }
+    }
+
+    [[nodiscard]] uint64_t claimed() const
+    {
+        return enqueue_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void run()
+    {
+        fmt::memory_buffer out;
+        while (true)
+        {
+            // Taken before looking at the slots, anything published from here on makes the wait below return
+            auto const published = published_.load(std::memory_order_acquire);
+            auto const stopping = stopping_.load(std::memory_order_acquire);
+
+            out.clear();
+            // In order, a record claimed earlier but still being filled in holds up the ones after it
+            while (true)
+            {
+                auto& slot = slots_[dequeue_ % QUEUE_SIZE];
+                if (slot.sequence.load(std::memory_order_acquire) != dequeue_ + 1) break;
+                auto const& record = slot.record;
+                fmt::format_to(std::back_inserter(out), "[{} {}:{}] ", record.level, record.file, record.line);
+                out.append(record.text.data(), record.text.data() + record.length);
+                if (record.truncated) out.append(std::string_view{"..."});
+                out.push_back('\n');
+                slot.sequence.store(dequeue_ + QUEUE_SIZE, std::memory_order_release);
+                ++dequeue_;
+            }
+            if (auto const dropped = dropped_.exchange(0, std::memory_order_relaxed); dropped > 0)
+            {
+                fmt::format_to(std::back_inserter(out), "[{}] {} log messages dropped, the queue was full\n", LogLevel::warn, dropped);
+            }
+
+            if (out.size() > 0)
+            {
+                std::fwrite(out.data(), 1, out.size(), stdout);
+                std::fflush(stdout);
+                written_.store(dequeue_, std::memory_order_release);
+                written_.notify_all();
+            }
+            else if (stopping)
+            {
+                return;
+            }
+            else
+            {
+                published_.wait(published, std::memory_order_acquire);
+            }
+        }
+    }
+
+    std::array<Slot, QUEUE_SIZE> slots_;
+    alignas(64) std::atomic<uint64_t> enqueue_{0};
+    alignas(64) std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> dropped_{0};
+    alignas(64) std::atomic<uint64_t> written_{0};
+    std::atomic<bool> stopping_{false};
+    // Logging thread only
+    uint64_t dequeue_{0};
+    std::thread thread_;
+};
+
+Logger& logger()
+{
+    static Logger instance;
+    return instance;
+}
+
+} // namespace
+
+logging::Record* logging::detail::claim()
+{
+    return logger().claim();
+}
+
+void logging::detail::publish(Record& record)
+{
+    logger().publish(record);
+}
+
+void logging::detail::wait_written(uint64_t const position)
+{
+    logger().wait_written(position);
+}
+
+void logging::flush()
+{
+    auto& instance = logger();
+    auto const claimed = instance.claimed();
+    if (claimed > 0) instance.wait_written(claimed - 1);
+}
@@ -1,4 +1,7 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <source_location>
 #include <fmt/format.h>
 #include <string_view>
@@ -27,11 +30,71 @@ struct fmt::formatter<LogLevel>: formatter<std::string_view> {
   }
 };
 
+// Levels below this are compiled out, arguments and all
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+// Messages are formatted by the thread logging them, straight into a slot of a lock-free queue, and a logging thread
+// adds the rest and writes them out. Logging never waits on the terminal, only errors wait until they have been written
+namespace logging
+{
+
+constexpr LogLevel MIN_LEVEL {static_cast<LogLevel>(LOG_MIN_LEVEL)};
+constexpr size_t MESSAGE_SIZE {256};
+
+struct Record
+{
+    // Of the queue, set when the record is claimed
+    uint64_t position;
+    char const* file;
+    uint32_t line;
+    LogLevel level;
+    bool truncated;
+    uint16_t length;
+    std::array<char, MESSAGE_SIZE> text;
+};
+
+namespace detail
+{
+
+// A free record to fill in, nullptr when the queue is full and the message has to be dropped
+[[nodiscard]] Record* claim();
+// Hands a claimed record over to the logging thread
+void publish(Record& record);
+// Until the logging thread has written everything up to position
+void wait_written(uint64_t const position);
+
+} // namespace detail
+
+template <typename... Args>
+void push(LogLevel const level, char const* file, uint32_t const line, fmt::format_string<Args...> format, Args&&... args)
+{
+    auto* record = detail::claim();
+    if (record == nullptr) return;
+
+    auto const result = fmt::format_to_n(record->text.data(), record->text.size(), format, std::forward<Args>(args)...);
+    record->file = file;
+    record->line = line;
+    record->level = level;
+    record->truncated = result.size > record->text.size();
+    record->length = static_cast<uint16_t>(std::min(result.size, record->text.size()));
+    auto const position = record->position;
+    detail::publish(*record);
+    // Usually followed by a throw, possibly all the way out of main, they have to be out by then
+    if (level >= LogLevel::error) detail::wait_written(position);
+}
+
+// Waits until everything logged so far is written, before writing to the same stream some other way
+void flush();
+
+} // namespace logging
+
 #define LOG(msg, lvl, ...) do { \
-    constexpr auto location {std::source_location::current()}; \
-    /* fmt::print("[{} {}:{}:{}]", lvl, location.file_name(), location.function_name(), location.line()); */ \
-    fmt::print("[{} {}:{}] ", lvl, location.file_name(), location.line()); \
-    fmt::println(msg, ##__VA_ARGS__); \
+    if constexpr (lvl >= ::logging::MIN_LEVEL) { \
+        constexpr auto location {std::source_location::current()}; \
+        ::logging::push(lvl, location.file_name(), location.line(), msg, ##__VA_ARGS__); \
+    } \
 } while (false);
 
 #define debug(msg, ...) LOG(msg, LogLevel::debug, ##__VA_ARGS__)
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// How often a loop runs and how long its iterations take. Only the thread running the loop records,
+// any one other thread may take the totals.
+class LoopTimer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Summary
+    {
+        double per_second;
+        double mean_ms;
+        double worst_ms;
+    };
+
+    void record(Clock::duration const elapsed)
+    {
+        auto const ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        count_.fetch_add(1, std::memory_order_relaxed);
+        total_ns_.fetch_add(ns, std::memory_order_relaxed);
+        if (ns > worst_ns_.load(std::memory_order_relaxed)) worst_ns_.store(ns, std::memory_order_relaxed);
+    }
+
+    // Since the previous call, which starts the next period
+    Summary take()
+    {
+        auto const now = Clock::now();
+        auto const seconds = std::chrono::duration<double>(now - since_).count();
+        since_ = now;
+        auto const count = static_cast<double>(count_.exchange(0, std::memory_order_relaxed));
+        auto const total_ms = static_cast<double>(total_ns_.exchange(0, std::memory_order_relaxed)) / 1e6;
+        auto const worst_ms = static_cast<double>(worst_ns_.exchange(0, std::memory_order_relaxed)) / 1e6;
+        return {count / seconds, count > 0. ? total_ms / count : 0., worst_ms};
+    }
+
+private:
+    alignas(64) std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> total_ns_{0};
+    std::atomic<uint64_t> worst_ns_{0};
+    // Taking side only
+    alignas(64) Clock::time_point since_{Clock::now()};
+};
@@ -1,17 +1,82 @@
+#include <filesystem>
+#include <string_view>
 #include "log.hpp"
 #include "app.hpp"
+#include "headless.hpp"
+#include "profiler.hpp"
 #include "utils.hpp"
 
-
-int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) 
+// Usage: renderer [--record file] [--replay file] [--headless-bench [file]] [--trace file]
+//   --record          records the session's input into file
+//   --replay          plays a recorded session back without a window and checks it ends the same
+//   --headless-bench  times the simulation without a window, JSON goes to file or stdout
+//   --trace           writes the profiled zones of the run into file as a Chrome trace, needs a build with profiling
+int main(int argc, char* argv[]) 
 {
-    debug("Starting the app");
+    AppOptions options;
+    std::filesystem::path replay_path;
+    bool headless_benchmark{false};
+    std::filesystem::path benchmark_output;
+    std::filesystem::path trace_path;
+    for (int idx{1}; idx < argc; ++idx)
+    {
+        std::string_view const arg {argv[idx]};
+        if (arg == "--record" and idx + 1 < argc)
+        {
+            options.record = argv[++idx];
+        }
+        else if (arg == "--replay" and idx + 1 < argc)
+        {
+            replay_path = argv[++idx];
+        }
+        else if (arg == "--headless-bench")
+        {
+            headless_benchmark = true;
+            if (idx + 1 < argc and not std::string_view{argv[idx + 1]}.starts_with("--")) benchmark_output = argv[++idx];
+        }
+        else if (arg == "--trace" and idx + 1 < argc)
+        {
+            trace_path = argv[++idx];
+        }
+        else
+        {
+            error("Unknown argument {}, usage: renderer [--record file] [--replay file] [--headless-bench [file]] [--trace file]", arg);
+            return 1;
+        }
+    }
+
+    if (not trace_path.empty())
+    {
+        if (not profiler::ENABLED)
+        {
+            error("--trace needs a build with profiling, configure with -Dprofiling=true");
+            return 1;
+        }
+        profiler::start();
+        profiler::name_thread("main");
+    }
+
     try {
-        App app {"Minecraft2"};
-        app.run();
+        int status{0};
+        if (not replay_path.empty())
+        {
+            status = replay(replay_path);
+        }
+        else if (headless_benchmark)
+        {
+            status = headless_bench(benchmark_output);
+        }
+        else
+        {
+            debug("Starting the app");
+            App app {"Minecraft2", options};
+            app.run();
+        }
+        // Everything recording zones has stopped with the app
+        if (not trace_path.empty()) profiler::write_trace(trace_path);
+        return status;
     } catch (utils::FatalError const& except) {
         error("Fatal error occured at {}", except.where());
+        return 1;
     }
-    return 0;
-} 
-
+}
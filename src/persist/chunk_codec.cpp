@@ -0,0 +1,115 @@
+#include <bit>
+#include <cstring>
+#include <type_traits>
+#include "persist/chunk_codec.hpp"
+
+static_assert(std::endian::native == std::endian::little, "Saves are written in native byte order");
+
+namespace
+{
+
+template <typename T>
+void append(std::vector<uint8_t>& out, std::span<T const> values)
+{
+    auto const* bytes = reinterpret_cast<uint8_t const*>(values.data());
+    out.insert(out.end(), bytes, bytes + values.size_bytes());
+}
+
+template <typename T>
+void append(std::vector<uint8_t>& out, T const value)
+{
+    append(out, std::span<T const>{&value, 1});
+}
+
+// Reads count values of T off the front of bytes, the copy also takes care of alignment
+template <typename T>
+bool take(std::span<uint8_t const>& bytes, std::vector<T>& values, size_t const count)
+{
+    if (bytes.size() < count * sizeof(T)) return false;
+    values.resize(count);
+    if (count == 0) return true;
+    std::memcpy(values.data(), bytes.data(), count * sizeof(T));
+    bytes = bytes.subspan(count * sizeof(T));
+    return true;
+}
+
+template <typename T>
+bool take(std::span<uint8_t const>& bytes, T& value)
+{
+    if (bytes.size() < sizeof(T)) return false;
+    std::memcpy(&value, bytes.data(), sizeof(T));
+    bytes = bytes.subspan(sizeof(T));
+    return true;
+}
+
+constexpr uint8_t LAYOUT_SHIFT {7};
+
+template <typename Layout>
+bool assign(ChunkSection& section, uint8_t const bits, std::span<Block const> palette, std::span<uint64_t const> words)
+{
+    if constexpr (std::is_same_v<Layout, SectionLayout>)
+    {
+        return section.assign(bits, palette, words);
+    }
+    else
+    {
+        BasicChunkSection<Layout> stored;
+        if (not stored.assign(bits, palette, words)) return false;
+        if (stored.uniform())
+        {
+            section.fill(stored.palette()[0]);
+            return true;
+        }
+        // Rare, only the first load after switching layouts
+        section.fill(Block::Air);
+        for (int y{}; y < SECTION_SIZE; ++y)
+        {
+            for (int z{}; z < SECTION_SIZE; ++z)
+            {
+                for (int x{}; x < SECTION_SIZE; ++x)
+                {
+                    section.set(x, y, z, stored.get(x, y, z));
+                }
+            }
+        }
+        section.compact();
+        return true;
+    }
+}
+
+} // namespace
+
+void encode_chunk(Chunk const& chunk, std::vector<uint8_t>& out)
+{
+    for (size_t idx{}; idx < SECTIONS_PER_CHUNK; ++idx)
+    {
+        auto const& section = chunk.section(idx);
+        append(out, static_cast<uint8_t>(section.bits() | (SectionLayout::ID << LAYOUT_SHIFT)));
+        append(out, static_cast<uint16_t>(section.palette().size()));
+        append(out, section.palette());
+        append(out, section.words());
+    }
+}
+
+bool decode_chunk(std::span<uint8_t const> bytes, Chunk& chunk)
+{
+    std::vector<Block> palette;
+    std::vector<uint64_t> words;
+    for (size_t idx{}; idx < SECTIONS_PER_CHUNK; ++idx)
+    {
+        uint8_t bits{};
+        uint16_t palette_size{};
+        if (not take(bytes, bits) or not take(bytes, palette_size) or not take(bytes, palette, palette_size)) return false;
+        // Saves from before layouts have the bit clear, which is the linear layout they were written in
+        auto const layout = bits >> LAYOUT_SHIFT;
+        bits &= (1u << LAYOUT_SHIFT) - 1;
+        // assign() rejects widths it doesn't know, the word count only has to be sane enough to read
+        if (bits > 16 or not take(bytes, words, SECTION_VOLUME * bits / 64)) return false;
+        auto& section = chunk.section(idx);
+        auto const assigned = layout == MortonLayout::ID
+            ? assign<MortonLayout>(section, bits, palette, words)
+            : assign<LinearLayout>(section, bits, palette, words);
+        if (not assigned) return false;
+    }
+    return bytes.empty();
+}
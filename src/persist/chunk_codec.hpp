@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "voxel/chunk.hpp"
+
+// Chunk contents as bytes, every section the way it sits in memory: bit width, palette size,
+// palette, packed index words. Nothing is unpacked, so encoding is a handful of copies.
+// The top bit of the bit width holds the section layout, saves from a build with the other layout
+// are reordered on load.
+// Multi-byte values are stored little endian, the native order of every platform the game runs on.
+
+// Appends the encoded chunk to out
+void encode_chunk(Chunk const& chunk, std::vector<uint8_t>& out);
+
+// Returns false, with the chunk possibly half filled, when the bytes don't hold a valid chunk
+[[nodiscard]] bool decode_chunk(std::span<uint8_t const> bytes, Chunk& chunk);
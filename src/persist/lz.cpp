@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include "persist/lz.hpp"
+
+namespace
+{
+
+constexpr size_t MIN_MATCH {4};
+constexpr size_t MAX_OFFSET {0xFFFF};
+constexpr int HASH_BITS {14};
+
+uint32_t read32(uint8_t const* data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32_t hash(uint32_t const sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Lengths of 15 and up continue in extra bytes, 255 meaning yet another one follows
+void write_length(std::vector<uint8_t>& out, size_t length)
+{
+    for (; length >= 255; length -= 255)
+    {
+        out.push_back(255);
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+void write_sequence(std::vector<uint8_t>& out, std::span<uint8_t const> literals, size_t const offset, size_t const match)
+{
+    auto const literal_nibble = std::min<size_t>(literals.size(), 15);
+    auto const match_nibble = match == 0 ? 0 : std::min<size_t>(match - MIN_MATCH, 15);
+    out.push_back(static_cast<uint8_t>((literal_nibble << 4) | match_nibble));
+    if (literal_nibble == 15) write_length(out, literals.size() - 15);
+    out.insert(out.end(), literals.begin(), literals.end());
+    if (match == 0) return;
+
+    out.push_back(static_cast<uint8_t>(offset));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (match_nibble == 15) write_length(out, match - MIN_MATCH - 15);
+}
+
+bool read_length(uint8_t const*& in, uint8_t const* end, size_t& length)
+{
+    for (;;)
+    {
+        if (in == end) return false;
+        auto const byte = *in++;
+        length += byte;
+        if (byte != 255) return true;
+    }
+}
+
+} // namespace
+
+void lz::compress(std::span<uint8_t const> input, std::vector<uint8_t>& out)
+{
+    // Last position each hashed 4 byte sequence was seen at, greedy matching against it
+    std::array<uint32_t, 1 << HASH_BITS> last_seen{};
+    auto const* data = input.data();
+    size_t anchor{};
+    size_t pos{};
+    while (pos + MIN_MATCH <= input.size())
+    {
+        auto const sequence = read32(data + pos);
+        auto& slot = last_seen[hash(sequence)];
+        size_t const candidate {slot};
+        slot = static_cast<uint32_t>(pos);
+        if (candidate >= pos or pos - candidate > MAX_OFFSET or read32(data + candidate) != sequence)
+        {
+            ++pos;
+            continue;
+        }
+
+        auto match = MIN_MATCH;
+        while (pos + match < input.size() and data[candidate + match] == data[pos + match])
+        {
+            ++match;
+        }
+        write_sequence(out, input.subspan(anchor, pos - anchor), pos - candidate, match);
+        pos += match;
+        anchor = pos;
+    }
+    write_sequence(out, input.subspan(anchor), 0, 0);
+}
+
+bool lz::decompress(std::span<uint8_t const> input, std::span<uint8_t> out)
+{
+    auto const* in = input.data();
+    auto const* const in_end = in + input.size();
+    auto* const begin = out.data();
+    auto* const end = begin + out.size();
+    auto* op = begin;
+
+    while (in < in_end)
+    {
+        auto const token = *in++;
+        size_t literals = token >> 4;
+        if (literals == 15 and not read_length(in, in_end, literals)) return false;
+        if (literals > static_cast<size_t>(in_end - in) or literals > static_cast<size_t>(end - op)) return false;
+        std::memcpy(op, in, literals);
+        in += literals;
+        op += literals;
+        // The last sequence has no match
+        if (in == in_end) break;
+
+        if (in_end - in < 2) return false;
+        size_t const offset = in[0] | (in[1] << 8);
+        in += 2;
+        size_t match = (token & 15);
+        if (match == 15 and not read_length(in, in_end, match)) return false;
+        match += MIN_MATCH;
+        if (offset == 0 or offset > static_cast<size_t>(op - begin) or match > static_cast<size_t>(end - op)) return false;
+
+        // Byte by byte, matches may overlap the bytes they produce
+        auto const* from = op - offset;
+        for (size_t idx{}; idx < match; ++idx)
+        {
+            op[idx] = from[idx];
+        }
+        op += match;
+    }
+    return op == end;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Small LZ77 compressor with an LZ4 style byte format, so saves don't depend on an external library.
+// A stream is a list of sequences: a token byte (literal count in the high nibble, match length - 4 in the
+// low one, 15 meaning more length bytes follow), the literals, then a 16 bit match offset.
+// The last sequence has literals only. Fast on both ends, and good at the repeated palette indices
+// and runs of zero words chunks are made of.
+namespace lz
+{
+
+// Appends the compressed input to out
+void compress(std::span<uint8_t const> input, std::vector<uint8_t>& out);
+
+// out has to be exactly the uncompressed size. Returns false on malformed input, never reads or writes out of bounds.
+[[nodiscard]] bool decompress(std::span<uint8_t const> input, std::span<uint8_t> out);
+
+} // namespace lz
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "persist/chunk_codec.hpp"
+#include "persist/lz.hpp"
+#include "persist/region.hpp"
+#include "utils.hpp"
+
+namespace
+{
+
+constexpr std::array<char, 4> MAGIC {'M', 'C', '2', 'R'};
+constexpr uint32_t VERSION {1};
+// Fully packed chunk with 16 bit indices everywhere, anything claiming more is corrupted
+constexpr size_t MAX_ENCODED_SIZE {SECTIONS_PER_CHUNK * (3 + 2 * 65536 + SECTION_VOLUME * 2)};
+
+} // namespace
+
+RegionFile::RegionFile(std::filesystem::path path) :
+    path_{std::move(path)}
+{
+    try
+    {
+        auto const size = open();
+        if (size == 0)
+        {
+            Header header{};
+            header.magic = MAGIC;
+            header.version = VERSION;
+            reserve(HEADER_SECTORS);
+            write({reinterpret_cast<uint8_t const*>(&header), sizeof(header)}, 0);
+        }
+        else
+        {
+            if (size < HEADER_SECTORS * SECTOR_SIZE) fail("Region file {} is truncated", path_.string());
+            reserve(sectors_for(size));
+            if (header().magic != MAGIC or header().version != VERSION)
+            {
+                fail("{} is not a version {} region file", path_.string(), VERSION);
+            }
+        }
+    }
+    catch (utils::FatalError const&)
+    {
+        // The destructor won't run
+        close();
+        throw;
+    }
+
+    // Entries pointing outside the file are corrupted, load() rejects them and they mustn't move the end either.
+    // Everything no entry points at is what earlier sessions left behind, free to reuse right away
+    end_sector_ = HEADER_SECTORS;
+    for (auto const& entry : header().entries)
+    {
+        if (entry.size == 0 or not inside_file(entry)) continue;
+        end_sector_ = std::max(end_sector_, entry.sector + sectors_for(entry.size));
+    }
+    used_.assign(end_sector_, false);
+    std::fill_n(used_.begin(), HEADER_SECTORS, true);
+    for (auto const& entry : header().entries)
+    {
+        if (entry.size != 0 and inside_file(entry)) mark(entry, true);
+    }
+}
+
+RegionFile::~RegionFile()
+{
+    close();
+}
+
+bool RegionFile::load(Chunk& chunk, std::vector<uint8_t>& scratch) const
+{
+    auto const& entry = header().entries[entry_index(chunk.pos())];
+    if (entry.size == 0) return false;
+
+    auto const reject = [&](std::string_view const reason) {
+        warn("Chunk {} {} in {} {}, generating it again", chunk.pos().x, chunk.pos().z, path_.string(), reason);
+        chunk = Chunk{chunk.pos()};
+        return false;
+    };
+
+    uint32_t encoded_size{};
+    if (not inside_file(entry) or entry.size < sizeof(encoded_size)) return reject("points outside the file");
+    std::span const payload {mapping_ + static_cast<size_t>(entry.sector) * SECTOR_SIZE, entry.size};
+    std::memcpy(&encoded_size, payload.data(), sizeof(encoded_size));
+    if (encoded_size > MAX_ENCODED_SIZE) return reject("has an impossible size");
+
+    scratch.resize(encoded_size);
+    if (not lz::decompress(payload.subspan(sizeof(encoded_size)), scratch)) return reject("doesn't decompress");
+    if (not decode_chunk(scratch, chunk)) return reject("is corrupted");
+    return true;
+}
+
+void RegionFile::save(Chunk const& chunk)
+{
+    encoded_.clear();
+    encode_chunk(chunk, encoded_);
+    auto const encoded_size = static_cast<uint32_t>(encoded_.size());
+    compressed_.resize(sizeof(encoded_size));
+    std::memcpy(compressed_.data(), &encoded_size, sizeof(encoded_size));
+    lz::compress(encoded_, compressed_);
+
+    // Never over the old payload, the header entry only switches over once the new one is complete
+    auto const idx = entry_index(chunk.pos());
+    Entry const entry {allocate(sectors_for(compressed_.size())), static_cast<uint32_t>(compressed_.size())};
+    if (end_sector_ > mapped_sectors_)
+    {
+        // Grows by half again, so appending chunk after chunk remaps a logarithmic number of times
+        reserve(std::max<size_t>(end_sector_, mapped_sectors_ + mapped_sectors_ / 2));
+    }
+
+    auto const old = header().entries[idx];
+    if (old.size != 0 and inside_file(old)) replaced_.push_back(old);
+
+    // Payload first, a crash in between leaves the header pointing at the old version of the chunk
+    write(compressed_, static_cast<size_t>(entry.sector) * SECTOR_SIZE);
+    write({reinterpret_cast<uint8_t const*>(&entry), sizeof(entry)}, offsetof(Header, entries) + idx * sizeof(Entry));
+}
+
+bool RegionFile::inside_file(Entry const& entry) const
+{
+    // In size_t, a corrupted sector near the top of uint32_t would wrap around
+    return entry.sector >= HEADER_SECTORS and static_cast<size_t>(entry.sector) + sectors_for(entry.size) <= mapped_sectors_;
+}
+
+uint32_t RegionFile::allocate(uint32_t const sectors)
+{
+    uint32_t run{};
+    for (uint32_t sector{HEADER_SECTORS}; sector < end_sector_; ++sector)
+    {
+        run = used_[sector] ? 0 : run + 1;
+        if (run == sectors)
+        {
+            Entry const found {sector + 1 - sectors, sectors * static_cast<uint32_t>(SECTOR_SIZE)};
+            mark(found, true);
+            return found.sector;
+        }
+    }
+
+    // A free run at the very end only needs topping up
+    auto const start = end_sector_ - run;
+    end_sector_ = start + sectors;
+    used_.resize(end_sector_, false);
+    mark({start, sectors * static_cast<uint32_t>(SECTOR_SIZE)}, true);
+    return start;
+}
+
+void RegionFile::mark(Entry const& entry, bool const used)
+{
+    auto const first = used_.begin() + entry.sector;
+    std::fill(first, first + sectors_for(entry.size), used);
+}
+
+void RegionFile::release_replaced()
+{
+    for (auto const& entry : replaced_)
+    {
+        mark(entry, false);
+    }
+    replaced_.clear();
+    // Free sectors at the end are left to the next append rather than kept as a run
+    while (end_sector_ > HEADER_SECTORS and not used_[end_sector_ - 1]) --end_sector_;
+    used_.resize(end_sector_);
+}
+
+#ifdef _WIN32
+
+// No mmap here: the whole file is read into contents_, mapping_ points at it and writes go to both.
+// flush() only hands the data to the OS, without an fsync the standard library offers
+size_t RegionFile::open()
+{
+    // Opening for reading and writing doesn't create the file
+    if (not std::filesystem::exists(path_)) std::ofstream{path_, std::ios::binary};
+    file_.open(path_, std::ios::in | std::ios::out | std::ios::binary);
+    if (not file_) fail("Can't open region file {}", path_.string());
+
+    std::error_code failed;
+    auto const size = static_cast<size_t>(std::filesystem::file_size(path_, failed));
+    if (failed) fail("Can't get the size of region file {}: {}", path_.string(), failed.message());
+    contents_.resize(size);
+    if (not file_.read(reinterpret_cast<char*>(contents_.data()), static_cast<std::streamsize>(size)))
+    {
+        fail("Can't read region file {}", path_.string());
+    }
+    return size;
+}
+
+void RegionFile::flush()
+{
+    if (not file_.flush()) fail("Can't flush region file {}", path_.string());
+    release_replaced();
+}
+
+void RegionFile::close()
+{
+    if (file_.is_open()) file_.close();
+    mapping_ = nullptr;
+}
+
+void RegionFile::write(std::span<uint8_t const> bytes, size_t const offset)
+{
+    std::memcpy(contents_.data() + offset, bytes.data(), bytes.size());
+    file_.seekp(static_cast<std::streamoff>(offset));
+    if (not file_.write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+    {
+        fail("Can't write region file {}", path_.string());
+    }
+}
+
+void RegionFile::reserve(size_t const sectors)
+{
+    auto const size = sectors * SECTOR_SIZE;
+    if (size > contents_.size())
+    {
+        // Writing the last byte grows the file, the rest reads as zeros
+        contents_.resize(size);
+        file_.seekp(static_cast<std::streamoff>(size - 1));
+        if (not file_.put(0)) fail("Can't grow region file {}", path_.string());
+    }
+    mapping_ = contents_.data();
+    mapped_sectors_ = sectors;
+}
+
+#else
+
+size_t RegionFile::open()
+{
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) fail("Can't open region file {}: {}", path_.string(), std::strerror(errno));
+    struct stat info{};
+    if (::fstat(fd_, &info) != 0) fail("Can't stat region file {}: {}", path_.string(), std::strerror(errno));
+    return static_cast<size_t>(info.st_size);
+}
+
+void RegionFile::flush()
+{
+    if (::fsync(fd_) != 0) fail("Can't flush region file {}: {}", path_.string(), std::strerror(errno));
+    release_replaced();
+}
+
+void RegionFile::close()
+{
+    if (mapping_ != nullptr) ::munmap(const_cast<uint8_t*>(mapping_), mapped_sectors_ * SECTOR_SIZE);
+    if (fd_ >= 0) ::close(fd_);
+    mapping_ = nullptr;
+    fd_ = -1;
+}
+
+void RegionFile::write(std::span<uint8_t const> bytes, size_t offset)
+{
+    while (not bytes.empty())
+    {
+        auto const written = ::pwrite(fd_, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+        if (written < 0 and errno == EINTR) continue;
+        if (written <= 0) fail("Can't write region file {}: {}", path_.string(), std::strerror(errno));
+        bytes = bytes.subspan(static_cast<size_t>(written));
+        offset += static_cast<size_t>(written);
+    }
+}
+
+void RegionFile::reserve(size_t const sectors)
+{
+    auto const size = sectors * SECTOR_SIZE;
+    if (sectors > mapped_sectors_ and ::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+    {
+        fail("Can't grow region file {}: {}", path_.string(), std::strerror(errno));
+    }
+
+    if (mapping_ != nullptr) ::munmap(const_cast<uint8_t*>(mapping_), mapped_sectors_ * SECTOR_SIZE);
+    auto* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) fail("Can't map region file {}: {}", path_.string(), std::strerror(errno));
+    mapping_ = static_cast<uint8_t const*>(mapping);
+    mapped_sectors_ = sectors;
+}
+
+#endif
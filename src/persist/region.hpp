@@ -0,0 +1,126 @@
+#pragma once
+#include <array>
+#include <filesystem>
+#ifdef _WIN32
+#include <fstream>
+#endif
+#include <span>
+#include <vector>
+#include "voxel/chunk.hpp"
+
+// SIZE x SIZE chunks in one file made of SECTOR_SIZE byte sectors:
+//   header   magic, format version, then per chunk its first sector and payload size (0 when never saved)
+//   payloads uncompressed size followed by the lz compressed chunk, each starting on a sector boundary
+// Reads go through a read only mapping of the whole file, loading a chunk is a view of its sectors plus decompression.
+// Windows builds read the whole file into memory instead. Writes go through pwrite. Every save writes the chunk to
+// free sectors and then points its header entry at it, so a process crashing mid-write leaves the previous version
+// readable. Only flush() orders writes for the disk though: after a power loss, saves since the last flush may be lost
+// or point at payloads that never made it.
+// Sectors a save leaves behind are free again once the header no longer pointing at them is flushed, later saves
+// fill them before the file grows.
+// Not thread safe, RegionStorage takes care of locking.
+class RegionFile
+{
+public:
+    static constexpr int SIZE {32};
+    // Compressed chunks are well under a kilobyte, page sized sectors would mostly hold padding
+    static constexpr size_t SECTOR_SIZE {512};
+
+    // Opens the file, creating an empty region if it doesn't exist. Fails on files that are truncated or not a region
+    explicit RegionFile(std::filesystem::path path);
+    ~RegionFile();
+
+    RegionFile(RegionFile const&) = delete;
+    RegionFile& operator=(RegionFile const&) = delete;
+
+    [[nodiscard]] bool contains(ChunkPos const pos) const
+    {
+        return header().entries[entry_index(pos)].size != 0;
+    }
+
+    // Fills in a freshly created chunk. False when the chunk was never saved or doesn't read back,
+    // the chunk is all air again in that case.
+    bool load(Chunk& chunk, std::vector<uint8_t>& scratch) const;
+    void save(Chunk const& chunk);
+    // Makes everything saved so far durable, and the sectors of the versions it replaced reusable
+    void flush();
+
+    [[nodiscard]] size_t file_size() const
+    {
+        return static_cast<size_t>(end_sector_) * SECTOR_SIZE;
+    }
+
+    [[nodiscard]] static ChunkPos region_of(ChunkPos const pos)
+    {
+        return {pos.x >> 5, pos.z >> 5};
+    }
+
+private:
+    static_assert(SIZE == 32, "region_of and entry_index shift by 5");
+
+    struct Entry
+    {
+        uint32_t sector;
+        uint32_t size;
+    };
+
+    struct Header
+    {
+        std::array<char, 4> magic;
+        uint32_t version;
+        std::array<uint32_t, 2> reserved;
+        std::array<Entry, SIZE * SIZE> entries;
+    };
+
+    static constexpr size_t HEADER_SECTORS {(sizeof(Header) + SECTOR_SIZE - 1) / SECTOR_SIZE};
+
+    [[nodiscard]] static size_t entry_index(ChunkPos const pos)
+    {
+        return static_cast<size_t>((pos.x & (SIZE - 1)) + (pos.z & (SIZE - 1)) * SIZE);
+    }
+
+    [[nodiscard]] static uint32_t sectors_for(size_t const bytes)
+    {
+        return static_cast<uint32_t>((bytes + SECTOR_SIZE - 1) / SECTOR_SIZE);
+    }
+
+    [[nodiscard]] Header const& header() const
+    {
+        return *reinterpret_cast<Header const*>(mapping_);
+    }
+
+    // Its payload lies between the header and the end of the mapped file
+    [[nodiscard]] bool inside_file(Entry const& entry) const;
+
+    // First run of free sectors long enough, at the end of the file when there is none
+    [[nodiscard]] uint32_t allocate(uint32_t const sectors);
+    void mark(Entry const& entry, bool const used);
+    // Saves since the last flush may have moved the header away from these, they are free once it is durable
+    void release_replaced();
+
+    // Opens or creates the file, returns its size
+    [[nodiscard]] size_t open();
+    void close();
+    void write(std::span<uint8_t const> bytes, size_t const offset);
+    // Grows the file to at least `sectors` and maps all of it
+    void reserve(size_t const sectors);
+
+    std::filesystem::path path_;
+#ifdef _WIN32
+    std::fstream file_;
+    // The whole file, mapping_ points at it
+    std::vector<uint8_t> contents_;
+#else
+    int fd_{-1};
+#endif
+    uint8_t const* mapping_{nullptr};
+    size_t mapped_sectors_{0};
+    // First sector past the last payload, chunks that fit no free run go there
+    uint32_t end_sector_{0};
+    // Per sector up to end_sector_, whether a header entry points into it
+    std::vector<bool> used_;
+    // Payloads replaced since the last flush, still used until then
+    std::vector<Entry> replaced_;
+    std::vector<uint8_t> encoded_;
+    std::vector<uint8_t> compressed_;
+};
@@ -0,0 +1,102 @@
+#include <fmt/format.h>
+#include "persist/storage.hpp"
+#include "utils.hpp"
+
+RegionStorage::RegionStorage(std::filesystem::path directory) :
+    directory_{std::move(directory)}
+{
+    std::filesystem::create_directories(directory_);
+}
+
+bool RegionStorage::load(Chunk& chunk)
+{
+    // Decompression scratch per thread, loads run on every job system thread
+    thread_local std::vector<uint8_t> scratch;
+    auto& found = region(chunk.pos());
+    std::shared_lock lock{found.mutex};
+    return found.file != nullptr and found.file->load(chunk, scratch);
+}
+
+void RegionStorage::save(Chunk const& chunk)
+{
+    auto& found = region(chunk.pos());
+    std::unique_lock lock{found.mutex};
+    if (found.file == nullptr) found.file = std::make_unique<RegionFile>(path(RegionFile::region_of(chunk.pos())));
+    found.file->save(chunk);
+}
+
+void RegionStorage::flush()
+{
+    // Regions are never dropped, so the pointers outlive the map lock and loads elsewhere don't wait on the disk.
+    // Flushing frees sectors, the region is locked like for a save
+    for (auto* region : regions())
+    {
+        std::unique_lock lock{region->mutex};
+        if (region->file != nullptr) region->file->flush();
+    }
+}
+
+size_t RegionStorage::disk_usage()
+{
+    size_t total{};
+    for (auto* region : regions())
+    {
+        std::shared_lock lock{region->mutex};
+        if (region->file != nullptr) total += region->file->file_size();
+    }
+    return total;
+}
+
+std::vector<RegionStorage::Region*> RegionStorage::regions()
+{
+    std::lock_guard lock{regions_mutex_};
+    std::vector<Region*> all;
+    for (auto& [pos, region] : regions_)
+    {
+        all.push_back(region.get());
+    }
+    return all;
+}
+
+RegionStorage::Region& RegionStorage::region(ChunkPos const chunk)
+{
+    auto const region_pos = RegionFile::region_of(chunk);
+    std::lock_guard lock{regions_mutex_};
+    auto& region = regions_[region_pos];
+    if (region == nullptr)
+    {
+        region = std::make_unique<Region>();
+        auto const file_path = path(region_pos);
+        if (std::filesystem::exists(file_path)) region->file = open_existing(file_path);
+    }
+    return *region;
+}
+
+std::unique_ptr<RegionFile> RegionStorage::open_existing(std::filesystem::path const& file_path)
+{
+    try
+    {
+        return std::make_unique<RegionFile>(file_path);
+    }
+    catch (utils::FatalError const&)
+    {
+        // Left behind half written by a crash or not a region file at all. Moved aside, the region counts as never
+        // saved and its chunks generate again
+        auto aside = file_path;
+        aside += ".corrupt";
+        std::error_code failed;
+        std::filesystem::rename(file_path, aside, failed);
+        if (failed)
+        {
+            warn("Region file {} is unusable and can't be moved aside: {}, its chunks won't be saved", file_path.string(), failed.message());
+            return nullptr;
+        }
+        warn("Region file {} is unusable, moved it to {} and generating its chunks again", file_path.string(), aside.string());
+        return nullptr;
+    }
+}
+
+std::filesystem::path RegionStorage::path(ChunkPos const region) const
+{
+    return directory_ / fmt::format("r.{}.{}.region", region.x, region.z);
+}
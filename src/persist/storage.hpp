@@ -0,0 +1,44 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include "persist/region.hpp"
+
+// A world's directory of region files, usable from any number of threads.
+// Loads from the same region run in parallel, a save or flush has its region to itself.
+// Region files are opened on first use and stay open. Unusable ones are moved aside and regenerated, like corrupted
+// chunks are.
+class RegionStorage
+{
+public:
+    explicit RegionStorage(std::filesystem::path directory);
+
+    // Same contract as RegionFile::load, false for chunks that were never saved
+    bool load(Chunk& chunk);
+    void save(Chunk const& chunk);
+    void flush();
+
+    // Bytes used by every region file opened so far
+    [[nodiscard]] size_t disk_usage();
+
+private:
+    struct Region
+    {
+        std::shared_mutex mutex;
+        // Stays empty until the file exists, regions nobody saved to are never created by loading
+        std::unique_ptr<RegionFile> file;
+    };
+
+    Region& region(ChunkPos const chunk);
+    // Nullptr when the file is unusable
+    [[nodiscard]] static std::unique_ptr<RegionFile> open_existing(std::filesystem::path const& file_path);
+    [[nodiscard]] std::vector<Region*> regions();
+    [[nodiscard]] std::filesystem::path path(ChunkPos const region) const;
+
+    std::filesystem::path directory_;
+    std::mutex regions_mutex_;
+    std::unordered_map<ChunkPos, std::unique_ptr<Region>> regions_;
+};
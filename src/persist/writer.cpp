@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <tuple>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#include "persist/writer.hpp"
+#include "profiler.hpp"
+#include "utils.hpp"
+
+ChunkWriter::ChunkWriter(ChunkMap const& chunks, RegionStorage& storage, WritebackSettings const& settings) :
+    chunks_{chunks},
+    storage_{storage},
+    settings_{settings}
+{
+    thread_ = std::thread{[this] { run(); }};
+}
+
+ChunkWriter::~ChunkWriter()
+{
+    // Shutting down is the one place allowed to wait for the disk
+    for (auto const& [pos, since] : dirty_since_)
+    {
+        if (auto const* chunk = chunks_.get(pos)) enqueue(*chunk, true);
+    }
+    dirty_since_.clear();
+    dirty_order_.clear();
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+void ChunkWriter::mark_dirty(ChunkPos const pos)
+{
+    auto const now = Clock::now();
+    if (dirty_since_.try_emplace(pos, now).second) dirty_order_.push_back({pos, now});
+}
+
+void ChunkWriter::update()
+{
+    auto const start = Clock::now();
+    auto const due = start - settings_.autosave_delay;
+    auto budget = settings_.snapshot_budget;
+    while (budget > 0 and not dirty_order_.empty())
+    {
+        auto const [pos, since] = dirty_order_.front();
+        auto const found = dirty_since_.find(pos);
+        if (found == dirty_since_.end() or found->second != since)
+        {
+            dirty_order_.pop_front();
+            continue;
+        }
+        if (since > due) break;
+
+        if (not enqueue(*chunks_.get(pos), false))
+        {
+            ++stats_.backpressure;
+            break;
+        }
+        dirty_since_.erase(found);
+        dirty_order_.pop_front();
+        --budget;
+    }
+    record_hitch(start);
+}
+
+bool ChunkWriter::release(ChunkPos const pos)
+{
+    auto const found = dirty_since_.find(pos);
+    if (found == dirty_since_.end()) return true;
+
+    auto const start = Clock::now();
+    auto const queued = enqueue(*chunks_.get(pos), false);
+    if (queued)
+    {
+        dirty_since_.erase(found);
+    }
+    else
+    {
+        ++stats_.backpressure;
+    }
+    record_hitch(start);
+    return queued;
+}
+
+bool ChunkWriter::load(Chunk& chunk)
+{
+    std::unique_lock lock{mutex_};
+    auto const found = pending_.find(chunk.pos());
+    if (found == pending_.end())
+    {
+        lock.unlock();
+        return storage_.load(chunk);
+    }
+    // Snapshots never change once made, copying outside the lock is fine
+    auto const snapshot = found->second.chunk;
+    lock.unlock();
+    chunk = *snapshot;
+    return true;
+}
+
+WritebackStats const& ChunkWriter::stats()
+{
+    stats_.dirty = static_cast<uint32_t>(dirty_since_.size());
+    {
+        std::lock_guard lock{mutex_};
+        stats_.queued = static_cast<uint32_t>(pending_.size());
+    }
+    stats_.written = written_.load(std::memory_order_relaxed);
+    stats_.batches = batches_.load(std::memory_order_relaxed);
+    stats_.flushes = flushes_.load(std::memory_order_relaxed);
+    return stats_;
+}
+
+bool ChunkWriter::enqueue(Chunk const& chunk, bool const force)
+{
+    {
+        // Replacing a snapshot that's already pending needs no room
+        std::lock_guard lock{mutex_};
+        if (not force and pending_.size() >= settings_.queue_capacity and not pending_.contains(chunk.pos())) return false;
+    }
+
+    // Copied without holding the lock, the I/O thread never waits on the main thread's allocations.
+    // Blocks only, light isn't saved and stitching jobs may be writing it
+    auto copy = std::make_shared<Chunk>(chunk.pos());
+    for (size_t idx{}; idx < SECTIONS_PER_CHUNK; ++idx)
+    {
+        copy->section(idx) = chunk.section(idx);
+    }
+    std::shared_ptr<Chunk const> snapshot = std::move(copy);
+    bool wake{false};
+    {
+        std::lock_guard lock{mutex_};
+        auto& entry = pending_[chunk.pos()];
+        entry.chunk = std::move(snapshot);
+        entry.version = ++next_version_;
+        if (not entry.queued)
+        {
+            entry.queued = true;
+            queue_.push_back(chunk.pos());
+            wake = queue_.size() >= settings_.batch_size;
+        }
+    }
+    // Partial batches go out when the flush interval runs out
+    if (wake) wake_.notify_one();
+    return true;
+}
+
+void ChunkWriter::record_hitch(Clock::time_point const start)
+{
+    auto const elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    stats_.worst_hitch_ms = std::max(stats_.worst_hitch_ms, elapsed);
+}
+
+void ChunkWriter::run()
+{
+    profiler::name_thread("chunk writer");
+    // Below the main thread, when cores are short compressing chunks waits instead of stretching a frame.
+    // Linux applies nice values per thread, elsewhere it runs at normal priority
+#ifdef __linux__
+    if (::setpriority(PRIO_PROCESS, static_cast<id_t>(::gettid()), 10) != 0) debug("Chunk writer runs at normal priority");
+#endif
+
+    std::vector<Written> batch;
+    auto next_flush = Clock::now() + settings_.flush_interval;
+    bool unflushed{false};
+
+    std::unique_lock lock{mutex_};
+    while (true)
+    {
+        wake_.wait_until(lock, next_flush, [&] { return stopping_ or queue_.size() >= settings_.batch_size; });
+
+        batch.clear();
+        while (not queue_.empty() and batch.size() < settings_.batch_size)
+        {
+            auto& entry = pending_[queue_.front()];
+            queue_.pop_front();
+            entry.queued = false;
+            batch.push_back({entry.chunk, entry.version});
+        }
+        auto const done = stopping_ and queue_.empty();
+        lock.unlock();
+
+        if (not batch.empty())
+        {
+            PROFILE_SCOPE("write_batch");
+            write(batch);
+            unflushed = true;
+        }
+        if (done or Clock::now() >= next_flush)
+        {
+            if (unflushed)
+            {
+                storage_.flush();
+                flushes_.fetch_add(1, std::memory_order_relaxed);
+                unflushed = false;
+            }
+            next_flush = Clock::now() + settings_.flush_interval;
+        }
+        if (done) return;
+        lock.lock();
+    }
+}
+
+void ChunkWriter::write(std::vector<Written>& batch)
+{
+    // File order: grouped by region, then by position inside the region like the header entries
+    auto const order = [](Written const& written) {
+        auto const pos = written.chunk->pos();
+        auto const region = RegionFile::region_of(pos);
+        return std::tuple{region.x, region.z, pos.z & (RegionFile::SIZE - 1), pos.x & (RegionFile::SIZE - 1)};
+    };
+    std::ranges::sort(batch, {}, order);
+
+    for (auto const& written : batch)
+    {
+        try
+        {
+            storage_.save(*written.chunk);
+        }
+        catch (utils::FatalError const&)
+        {
+            // fail() already logged why, the rest of the batch may still make it
+            warn("Chunk {} {} was not saved", written.chunk->pos().x, written.chunk->pos().z);
+        }
+    }
+
+    std::lock_guard lock{mutex_};
+    for (auto const& written : batch)
+    {
+        // A newer snapshot came in meanwhile, it's queued again and stays visible to load()
+        auto const found = pending_.find(written.chunk->pos());
+        if (found != pending_.end() and found->second.version == written.version) pending_.erase(found);
+    }
+    written_.fetch_add(batch.size(), std::memory_order_relaxed);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "persist/storage.hpp"
+#include "voxel/chunk_map.hpp"
+
+struct WritebackSettings
+{
+    // A chunk is written this long after its first unsaved edit, later edits in between ride along for free
+    std::chrono::milliseconds autosave_delay{5000};
+    // Snapshots taken per update, bounds the main thread time of autosaving a big world
+    uint32_t snapshot_budget{16};
+    // Snapshots waiting for the I/O thread. When it's full dirty chunks stay dirty until it catches up
+    uint32_t queue_capacity{256};
+    // Chunks the I/O thread writes in one go, sorted so every region file sees a run of writes
+    uint32_t batch_size{32};
+    std::chrono::milliseconds flush_interval{2000};
+};
+
+struct WritebackStats
+{
+    // Edited chunks not handed to the I/O thread yet
+    uint32_t dirty{0};
+    // Handed over and not written yet
+    uint32_t queued{0};
+    // Updates that left due chunks dirty because the queue was full
+    uint64_t backpressure{0};
+    uint64_t written{0};
+    uint64_t batches{0};
+    uint64_t flushes{0};
+    // Longest the main thread spent in update() or release(), the hitch saving can cause
+    double worst_hitch_ms{0.0};
+};
+
+// Writes edited chunks back to storage on a thread of its own.
+// The main thread only marks chunks dirty and copies due ones into immutable snapshots, a bounded
+// amount per update, and never waits on the I/O thread: when the queue is full it keeps chunks dirty.
+// Repeated edits are coalesced twice, a dirty chunk is snapshotted once no matter how often it changes
+// and a newer snapshot replaces a queued one that wasn't picked up yet.
+// Snapshots stay visible until written, load() prefers them to the file so a chunk that is unloaded
+// and loaded again before its write finishes comes back as it was.
+// Destroying the writer saves everything still dirty and waits for the disk.
+class ChunkWriter
+{
+public:
+    ChunkWriter(ChunkMap const& chunks, RegionStorage& storage, WritebackSettings const& settings);
+    ~ChunkWriter();
+
+    ChunkWriter(ChunkWriter const&) = delete;
+    ChunkWriter& operator=(ChunkWriter const&) = delete;
+
+    // Main thread only, the chunk has to be loaded
+    void mark_dirty(ChunkPos const pos);
+    // Hands due dirty chunks to the I/O thread
+    void update();
+    // Called before a chunk is unloaded, snapshots it right away when dirty.
+    // False when the queue is full, the chunk has to stay loaded and be released again later.
+    [[nodiscard]] bool release(ChunkPos const pos);
+
+    // Any thread. The pending snapshot if there is one, what storage has otherwise
+    bool load(Chunk& chunk);
+
+    [[nodiscard]] WritebackStats const& stats();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Dirty
+    {
+        ChunkPos pos;
+        Clock::time_point since;
+    };
+
+    struct Pending
+    {
+        std::shared_ptr<Chunk const> chunk;
+        // Bumped by every new snapshot, the I/O thread only retires what it actually wrote
+        uint64_t version{0};
+        bool queued{false};
+    };
+
+    struct Written
+    {
+        std::shared_ptr<Chunk const> chunk;
+        uint64_t version;
+    };
+
+    bool enqueue(Chunk const& chunk, bool const force);
+    void record_hitch(Clock::time_point const start);
+    void run();
+    void write(std::vector<Written>& batch);
+
+    ChunkMap const& chunks_;
+    RegionStorage& storage_;
+    WritebackSettings settings_;
+
+    // Main thread only. Ordered by the first unsaved edit, entries whose chunk was saved or edited again
+    // since are stale and skipped, dirty_since_ has the current time
+    std::deque<Dirty> dirty_order_;
+    std::unordered_map<ChunkPos, Clock::time_point> dirty_since_;
+    WritebackStats stats_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::unordered_map<ChunkPos, Pending> pending_;
+    std::deque<ChunkPos> queue_;
+    uint64_t next_version_{0};
+    bool stopping_{false};
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> flushes_{0};
+    std::thread thread_;
+};
@@ -0,0 +1,112 @@
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "log.hpp"
+#include "profiler.hpp"
+#include "utils.hpp"
+
+namespace
+{
+
+struct Zone
+{
+    char const* name;
+    profiler::Clock::time_point start;
+    profiler::Clock::time_point end;
+};
+
+// Written only by its own thread, read once that one is done
+struct Ring
+{
+    explicit Ring(size_t const thread_id) :
+        id{thread_id},
+        zones(profiler::RING_SIZE)
+    {}
+
+    size_t id;
+    std::string name;
+    std::vector<Zone> zones;
+    std::atomic<uint64_t> written{0};
+};
+
+profiler::Clock::time_point epoch;
+// Rings stay around after their thread exits, for the trace
+std::mutex rings_mutex;
+std::vector<std::unique_ptr<Ring>> rings;
+thread_local Ring* own_ring {nullptr};
+
+Ring& ring()
+{
+    if (own_ring == nullptr)
+    {
+        std::lock_guard lock{rings_mutex};
+        own_ring = rings.emplace_back(std::make_unique<Ring>(rings.size())).get();
+    }
+    return *own_ring;
+}
+
+double microseconds(profiler::Clock::duration const duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+void profiler::detail::record(char const* name, Clock::time_point const start, Clock::time_point const end)
+{
+    auto& own = ring();
+    auto const written = own.written.load(std::memory_order_relaxed);
+    own.zones[written % RING_SIZE] = {name, start, end};
+    own.written.store(written + 1, std::memory_order_release);
+}
+
+void profiler::start()
+{
+    epoch = Clock::now();
+    detail::tracing.store(true, std::memory_order_relaxed);
+}
+
+void profiler::name_thread(std::string_view const name)
+{
+    if (tracing()) ring().name = name;
+}
+
+void profiler::write_trace(std::filesystem::path const& path)
+{
+    detail::tracing.store(false, std::memory_order_relaxed);
+
+    fmt::memory_buffer out;
+    auto inserter = std::back_inserter(out);
+    fmt::format_to(inserter, "{{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    auto first = true;
+    auto const separator = [&] { return std::exchange(first, false) ? "" : ",\n"; };
+
+    uint64_t dropped{};
+    std::lock_guard lock{rings_mutex};
+    for (auto const& thread : rings)
+    {
+        auto const name = thread->name.empty() ? fmt::format("thread {}", thread->id) : thread->name;
+        fmt::format_to(inserter, R"({}{{"name": "thread_name", "ph": "M", "pid": 1, "tid": {}, "args": {{"name": "{}"}}}})",
+            separator(), thread->id, name);
+
+        auto const written = thread->written.load(std::memory_order_acquire);
+        auto const from = written > RING_SIZE ? written - RING_SIZE : 0;
+        dropped += from;
+        for (auto idx = from; idx < written; ++idx)
+        {
+            auto const& zone = thread->zones[idx % RING_SIZE];
+            fmt::format_to(inserter, R"({}{{"name": "{}", "ph": "X", "pid": 1, "tid": {}, "ts": {:.3f}, "dur": {:.3f}}})",
+                separator(), zone.name, thread->id, microseconds(zone.start - epoch), microseconds(zone.end - zone.start));
+        }
+    }
+    fmt::format_to(inserter, "\n]}}\n");
+
+    std::ofstream file{path, std::ios::binary};
+    if (not file) fail("Can't write the trace to {}", path.string());
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (dropped > 0) warn("{} zones were overwritten before the trace was written, it only has the last {} per thread", dropped, RING_SIZE);
+    info("Wrote the trace to {}", path.string());
+}
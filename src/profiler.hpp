@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+
+// Scoped timing zones: PROFILE_SCOPE("mesh") times the rest of the enclosing block. Built without PROFILING they
+// compile to nothing, with it a zone costs a relaxed load while nobody traces.
+// Every thread records into a ring of its own, nothing is shared while zones are recorded. Once a ring is full the
+// newest zones overwrite the oldest, a trace has the last RING_SIZE zones of each thread.
+namespace profiler
+{
+
+using Clock = std::chrono::steady_clock;
+
+#ifdef PROFILING
+constexpr bool ENABLED {true};
+#else
+constexpr bool ENABLED {false};
+#endif
+
+constexpr size_t RING_SIZE {1 << 16};
+
+namespace detail
+{
+
+inline std::atomic<bool> tracing {false};
+
+// name has to outlive the trace, zones are named by string literals
+void record(char const* name, Clock::time_point const start, Clock::time_point const end);
+
+} // namespace detail
+
+[[nodiscard]] inline bool tracing()
+{
+    return detail::tracing.load(std::memory_order_relaxed);
+}
+
+// Zones only get recorded from here on
+void start();
+// Under this name in traces, threads that aren't named are numbered
+void name_thread(std::string_view const name);
+// Stops tracing and writes the zones as Chrome trace events, for chrome://tracing or Perfetto.
+// The threads that recorded zones have to be done by then
+void write_trace(std::filesystem::path const& path);
+
+class Scope
+{
+public:
+    explicit Scope(char const* name) :
+        name_{tracing() ? name : nullptr},
+        start_{name_ != nullptr ? Clock::now() : Clock::time_point{}}
+    {}
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+
+    ~Scope()
+    {
+        if (name_ != nullptr) detail::record(name_, start_, Clock::now());
+    }
+
+private:
+    char const* name_;
+    Clock::time_point start_;
+};
+
+} // namespace profiler
+
+#ifdef PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) profiler::Scope const PROFILE_CONCAT(profile_scope_, __LINE__) {name}
+#else
+#define PROFILE_SCOPE(name) do {} while (false)
+#endif
@@ -0,0 +1,202 @@
+#include "recording.hpp"
+#include <array>
+#include <cstring>
+#include <iterator>
+#include "utils.hpp"
+
+namespace
+{
+
+constexpr std::array<char, 4> MAGIC {'M', 'C', '2', 'I'};
+constexpr uint16_t VERSION {1};
+constexpr size_t HEADER_SIZE {MAGIC.size() + sizeof(uint16_t) + sizeof(float)};
+
+// What a record holds, one record per tick carries both
+constexpr uint8_t ACTIONS {1 << 0};
+constexpr uint8_t MOUSE {1 << 1};
+constexpr uint8_t END {1 << 7};
+
+constexpr size_t FLUSH_SIZE {64 * 1024};
+
+static_assert(static_cast<size_t>(Action::MAX_COUNT) <= 8, "Held actions are stored as an 8 bit mask");
+
+template <typename T>
+void put(std::vector<uint8_t>& out, T const& value)
+{
+    auto const* bytes = reinterpret_cast<uint8_t const*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+} // namespace
+
+InputRecorder::InputRecorder(std::filesystem::path const& path, float const time_per_tick) :
+    path_{path},
+    file_{path, std::ios::binary | std::ios::trunc}
+{
+    if (not file_) fail("Can't create recording {}", path_.string());
+    buffer_.insert(buffer_.end(), MAGIC.begin(), MAGIC.end());
+    put(buffer_, VERSION);
+    put(buffer_, time_per_tick);
+}
+
+InputRecorder::~InputRecorder()
+{
+    flush();
+}
+
+void InputRecorder::record(uint64_t const tick, UserInput const& input)
+{
+    uint8_t actions{};
+    for (auto const action : input.user_actions)
+    {
+        actions = static_cast<uint8_t>(actions | (1 << static_cast<int>(action)));
+    }
+
+    uint8_t kind{};
+    if (actions != actions_) kind |= ACTIONS;
+    if (input.mouse_delta != glm::vec2{0.f}) kind |= MOUSE;
+    if (kind == 0) return;
+
+    put_varint(buffer_, tick - last_tick_);
+    last_tick_ = tick;
+    buffer_.push_back(kind);
+    if (kind & ACTIONS)
+    {
+        buffer_.push_back(actions);
+        actions_ = actions;
+    }
+    if (kind & MOUSE)
+    {
+        put(buffer_, input.mouse_delta.x);
+        put(buffer_, input.mouse_delta.y);
+    }
+    if (buffer_.size() >= FLUSH_SIZE) flush();
+}
+
+void InputRecorder::finish(uint64_t const ticks, uint64_t const checksum)
+{
+    if (finished_) return;
+    finished_ = true;
+    put_varint(buffer_, ticks - last_tick_);
+    buffer_.push_back(END);
+    put(buffer_, ticks);
+    put(buffer_, checksum);
+    flush();
+}
+
+void InputRecorder::flush()
+{
+    file_.write(reinterpret_cast<char const*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+    file_.flush();
+    // Runs from the destructor too, a recording that can't be written isn't worth stopping the game for
+    if (not file_) error("Can't write recording {}", path_.string());
+    buffer_.clear();
+}
+
+InputReplay::InputReplay(std::filesystem::path const& path) :
+    path_{path}
+{
+    std::ifstream file {path, std::ios::binary};
+    if (not file) fail("Can't open recording {}", path_.string());
+    bytes_.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+
+    if (bytes_.size() < HEADER_SIZE or std::memcmp(bytes_.data(), MAGIC.data(), MAGIC.size()) != 0)
+    {
+        fail("{} is not a recording", path_.string());
+    }
+    uint16_t version{};
+    std::memcpy(&version, bytes_.data() + MAGIC.size(), sizeof(version));
+    if (version != VERSION) fail("{} is a version {} recording, version {} expected", path_.string(), version, VERSION);
+    std::memcpy(&time_per_tick_, bytes_.data() + MAGIC.size() + sizeof(version), sizeof(time_per_tick_));
+
+    // Walks the records once to check them and find the end
+    offset_ = HEADER_SIZE;
+    end_ = bytes_.size();
+    while (offset_ < bytes_.size())
+    {
+        auto const start = offset_;
+        read_record();
+        if (offset_ == start)
+        {
+            end_ = start;
+            break;
+        }
+    }
+
+    offset_ = HEADER_SIZE;
+    tick_ = 0;
+    next_record_ = 0;
+    if (offset_ < end_) next_record_ = read_varint();
+}
+
+UserInput const& InputReplay::next()
+{
+    input_.mouse_delta = {0.f, 0.f};
+    if (offset_ < end_ and next_record_ == tick_)
+    {
+        auto const kind = bytes_.at(offset_++);
+        if (kind & ACTIONS)
+        {
+            auto const actions = bytes_.at(offset_++);
+            input_.user_actions.clear();
+            for (uint8_t idx{}; idx < static_cast<uint8_t>(Action::MAX_COUNT); ++idx)
+            {
+                if (actions & (1 << idx)) input_.user_actions.push_back(static_cast<Action>(idx));
+            }
+        }
+        if (kind & MOUSE)
+        {
+            std::memcpy(&input_.mouse_delta, bytes_.data() + offset_, sizeof(input_.mouse_delta));
+            offset_ += sizeof(input_.mouse_delta);
+        }
+        if (offset_ < end_) next_record_ += read_varint();
+    }
+    ++tick_;
+    return input_;
+}
+
+uint64_t InputReplay::read_varint()
+{
+    uint64_t value{};
+    for (int shift{}; ; shift += 7)
+    {
+        if (offset_ >= bytes_.size() or shift > 63) fail("Recording {} is truncated", path_.string());
+        auto const byte = bytes_[offset_++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return value;
+    }
+}
+
+// Skips one record while checking it fits, an end record is read and left in place
+void InputReplay::read_record()
+{
+    auto const start = offset_;
+    read_varint();
+    if (offset_ >= bytes_.size()) fail("Recording {} is truncated", path_.string());
+    auto const kind = bytes_[offset_++];
+
+    size_t size{};
+    if (kind & END) size = 2 * sizeof(uint64_t);
+    if (kind & ACTIONS) size += 1;
+    if (kind & MOUSE) size += 2 * sizeof(float);
+    if (offset_ + size > bytes_.size()) fail("Recording {} is truncated", path_.string());
+
+    if (kind & END)
+    {
+        std::memcpy(&ticks_, bytes_.data() + offset_, sizeof(ticks_));
+        std::memcpy(&checksum_, bytes_.data() + offset_ + sizeof(ticks_), sizeof(checksum_));
+        offset_ = start;
+        return;
+    }
+    offset_ += size;
+}
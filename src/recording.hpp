@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "interfaces.hpp"
+
+// Tick by tick input of a session, enough to play it back into a lockstep World and get the same world out.
+// Only ticks where the held actions change or the mouse moves are stored, an idle minute costs nothing.
+// Layout, multi-byte values little endian:
+//   header  "MC2I", u16 version, f32 seconds per tick
+//   records varint ticks since the previous record, u8 what follows:
+//           ACTIONS  u8 mask of held actions, bit n for Action n
+//           MOUSE    f32 x, f32 y of the mouse delta
+//           END      u64 tick count, u64 world checksum. Nothing comes after
+// Mouse positions aren't stored, the world never looks at them.
+class InputRecorder
+{
+public:
+    InputRecorder(std::filesystem::path const& path, float const time_per_tick);
+    // Without finish() the file has no end record, replays still run it but have nothing to compare with
+    ~InputRecorder();
+
+    InputRecorder(InputRecorder const&) = delete;
+    InputRecorder& operator=(InputRecorder const&) = delete;
+
+    // Ticks in increasing order
+    void record(uint64_t const tick, UserInput const& input);
+    void finish(uint64_t const ticks, uint64_t const checksum);
+
+private:
+    void flush();
+
+    std::filesystem::path path_;
+    std::ofstream file_;
+    std::vector<uint8_t> buffer_;
+    uint64_t last_tick_{0};
+    uint8_t actions_{0};
+    bool finished_{false};
+};
+
+// Reads a whole recording up front and hands out the input of one tick after another
+class InputReplay
+{
+public:
+    explicit InputReplay(std::filesystem::path const& path);
+
+    [[nodiscard]] float time_per_tick() const
+    {
+        return time_per_tick_;
+    }
+
+    // Ticks the session ran, 0 when the recording has no end
+    [[nodiscard]] uint64_t ticks() const
+    {
+        return ticks_;
+    }
+
+    // Of the recorded world at the end, 0 when the recording has no end
+    [[nodiscard]] uint64_t checksum() const
+    {
+        return checksum_;
+    }
+
+    // Nothing left but idle ticks up to ticks()
+    [[nodiscard]] bool done() const
+    {
+        return offset_ >= end_;
+    }
+
+    // The input of the next tick, valid until the next call
+    UserInput const& next();
+
+private:
+    uint64_t read_varint();
+    void read_record();
+
+    std::filesystem::path path_;
+    std::vector<uint8_t> bytes_;
+    size_t offset_{0};
+    // Where the records stop, before the end record if there is one
+    size_t end_{0};
+    float time_per_tick_{0.f};
+    uint64_t ticks_{0};
+    uint64_t checksum_{0};
+
+    uint64_t tick_{0};
+    // Tick of the record at offset_
+    uint64_t next_record_{0};
+    UserInput input_;
+};
@@ -0,0 +1,80 @@
+#include "simulation.hpp"
+#include <utility>
+#include "profiler.hpp"
+
+namespace
+{
+
+// Behind by more than this the simulation gives up on catching up, a hitch shouldn't turn into a burst of ticks
+constexpr std::chrono::milliseconds MAX_LAG {100};
+
+} // namespace
+
+Simulation::Simulation(World& world, JobSystem& jobs, float const ticks_per_second, InputRecorder* recorder) :
+    world_{world},
+    jobs_{jobs},
+    tick_length_{std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>{1.f / ticks_per_second})},
+    recorder_{recorder},
+    snapshots_{world.to_render()}
+{
+    if (recorder_ != nullptr) world_.set_lockstep(true);
+    thread_ = std::thread{[this] { run(); }};
+}
+
+Simulation::~Simulation()
+{
+    stopping_.store(true, std::memory_order_relaxed);
+    thread_.join();
+    // Destroying the world waits for its jobs, which thread 0 does
+    jobs_.take_over();
+    if (recorder_ != nullptr) recorder_->finish(tick_, world_.checksum());
+}
+
+void Simulation::post(UserInput const& input)
+{
+    std::lock_guard lock{input_mutex_};
+    posted_.user_actions = input.user_actions;
+    posted_.mouse_position = input.mouse_position;
+    posted_.mouse_delta += input.mouse_delta;
+}
+
+RenderData const& Simulation::latest()
+{
+    acknowledged_.store(snapshots_.front().sequence, std::memory_order_relaxed);
+    snapshots_.acquire();
+    return snapshots_.front();
+}
+
+void Simulation::run()
+{
+    profiler::name_thread("simulation");
+    // Ticks submit the streaming jobs and, in lockstep, wait for them
+    jobs_.take_over();
+    auto next_tick = Clock::now();
+    while (not stopping_.load(std::memory_order_relaxed))
+    {
+        {
+            std::lock_guard lock{input_mutex_};
+            input_.user_actions = posted_.user_actions;
+            input_.mouse_position = posted_.mouse_position;
+            input_.mouse_delta = std::exchange(posted_.mouse_delta, glm::vec2{0.f});
+        }
+
+        if (recorder_ != nullptr) recorder_->record(tick_, input_);
+        ++tick_;
+
+        auto const start = Clock::now();
+        world_.tick(input_);
+        {
+            PROFILE_SCOPE("snapshot");
+            world_.to_render(snapshots_.back(), acknowledged_.load(std::memory_order_relaxed));
+            snapshots_.publish();
+        }
+        auto const end = Clock::now();
+        timer_.record(end - start);
+
+        next_tick += tick_length_;
+        if (end - next_tick > MAX_LAG) next_tick = end;
+        std::this_thread::sleep_until(next_tick);
+    }
+}
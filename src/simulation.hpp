@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "interfaces.hpp"
+#include "jobs.hpp"
+#include "loop_timer.hpp"
+#include "recording.hpp"
+#include "triple_buffer.hpp"
+#include "world.hpp"
+
+// Ticks the world on a thread of its own at a fixed rate, however fast or slow frames are drawn.
+// Every tick ends with a snapshot for the renderer, published through a triple buffer: the renderer draws the
+// newest finished one and the simulation always has a free one to fill, neither ever waits on the other.
+// Snapshots share the chunk meshes with the world, which replaces a mesh instead of changing it.
+// Once started the world belongs to the simulation thread until the Simulation is destroyed, and so does the world's
+// job system: the simulation thread takes over as its thread 0 and hands it back when it stops.
+// With a recorder every tick's input is recorded and the world runs in lockstep, so the session can be replayed.
+class Simulation
+{
+public:
+    Simulation(World& world, JobSystem& jobs, float const ticks_per_second, InputRecorder* recorder = nullptr);
+    ~Simulation();
+
+    Simulation(Simulation const&) = delete;
+    Simulation& operator=(Simulation const&) = delete;
+
+    // Held actions replace the previous ones, mouse movement adds up until a tick uses it
+    void post(UserInput const& input);
+    // The newest snapshot, stays valid until the next call. One thread only, and calling it again tells the
+    // simulation the renderer has taken the mesh updates of the previous one
+    [[nodiscard]] RenderData const& latest();
+
+    [[nodiscard]] LoopTimer& timer()
+    {
+        return timer_;
+    }
+
+private:
+    using Clock = LoopTimer::Clock;
+
+    void run();
+
+    World& world_;
+    JobSystem& jobs_;
+    Clock::duration tick_length_;
+    InputRecorder* recorder_;
+    // Simulation thread only
+    uint64_t tick_{0};
+
+    std::mutex input_mutex_;
+    UserInput posted_{};
+    // Simulation thread only, what the current tick sees
+    UserInput input_{};
+
+    TripleBuffer<RenderData> snapshots_;
+    // Sequence of the last snapshot the renderer is done with
+    std::atomic<uint64_t> acknowledged_{0};
+    LoopTimer timer_;
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
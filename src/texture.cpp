@@ -9,36 +9,51 @@ namespace
 
 std::filesystem::path const prefix {"res"};
 
-Image load_texture(std::string const& name, Device& device) 
+Image load_texture(std::vector<std::string> const& layers, Device& device) 
 {
-    auto const texture_path = prefix / name;
-    debug("Loading texture: {}", texture_path.string());
-    int x, y, chan;
-    auto const* pixels = stbi_load(texture_path.string().c_str(), &x, &y, &chan, STBI_rgb_alpha);
-    assert(pixels);
+    assert(not layers.empty());
+    std::vector<uint8_t> pixels;
+    VkExtent2D extent {};
+    for (auto const& name : layers)
+    {
+        auto const texture_path = prefix / name;
+        debug("Loading texture: {}", texture_path.string());
+        int x, y, chan;
+        auto* layer = stbi_load(texture_path.string().c_str(), &x, &y, &chan, STBI_rgb_alpha);
+        if (layer == nullptr) fail("Can't load texture {}", texture_path.string());
+
+        VkExtent2D const layer_extent { static_cast<uint32_t>(x), static_cast<uint32_t>(y) };
+        if (pixels.empty()) extent = layer_extent;
+        else if (layer_extent.width != extent.width or layer_extent.height != extent.height)
+        {
+            stbi_image_free(layer);
+            fail("Texture {} isn't {}x{} like the other layers", texture_path.string(), extent.width, extent.height);
+        }
+        pixels.insert(pixels.end(), layer, layer + x * y * 4);
+        stbi_image_free(layer);
+    }
 
     VkFormat format {VK_FORMAT_R8G8B8A8_SRGB};
-    VkExtent2D extent { static_cast<uint32_t>(x), static_cast<uint32_t>(y) };
     Image img 
     {
         device,
         format,
         extent,
         VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-        VK_IMAGE_ASPECT_COLOR_BIT
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        static_cast<uint32_t>(layers.size())
     };
 
-    size_t const size{x * y * 4u};
-    img.fill(pixels, size);
+    img.fill(pixels.data(), pixels.size());
     return img;
 }
 
 } // namespace
 
 
-Texture::Texture(Device& device, std::string const& name):
-    name_{name},
-    image_{load_texture(name, device)}
+Texture::Texture(Device& device, std::vector<std::string> const& layers):
+    layers_{layers},
+    image_{load_texture(layers, device)}
 {}
 
 Texture::~Texture() = default;
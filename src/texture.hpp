@@ -1,17 +1,19 @@
 #pragma once
 #include <string>
+#include <vector>
 #include "gfx/image.hpp"
 #include "utils.hpp"
 
 
+// 2D array texture, one layer per file. Every file has to be the same size
 class Texture {
 public:
-    Texture(Device& device, std::string const& name);
+    Texture(Device& device, std::vector<std::string> const& layers);
 
     ~Texture();
 
     CONST_GETTER(image);
 private:
-    std::string name_;
+    std::vector<std::string> layers_;
     Image image_;
 };
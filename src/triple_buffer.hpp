@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands values from one writer thread to one reader thread without either of them ever waiting.
+// Of the three slots the writer owns one, the reader owns one and the third is the one last published.
+// Publishing swaps the writer's slot with the middle one, acquiring swaps the reader's with it when it holds
+// something newer. The reader always sees the latest complete value, ones published in between are skipped.
+// Slots are reused, a T holding containers keeps their capacity from one round to the next.
+template <typename T>
+class TripleBuffer
+{
+public:
+    explicit TripleBuffer(T const& initial) :
+        slots_{initial, initial, initial}
+    {}
+
+    TripleBuffer(TripleBuffer const&) = delete;
+    TripleBuffer& operator=(TripleBuffer const&) = delete;
+
+    // Writer only, the slot to fill next. Still holds whatever it was filled with three rounds ago
+    [[nodiscard]] T& back()
+    {
+        return slots_[back_];
+    }
+
+    // Writer only
+    void publish()
+    {
+        // Release makes the value visible to the reader, acquire makes sure it is done with the slot coming back
+        auto const previous = middle_.exchange(static_cast<uint8_t>(back_ | FRESH), std::memory_order_acq_rel);
+        back_ = previous & INDEX;
+    }
+
+    // Reader only. Swaps in the latest value, false when nothing was published since the last call
+    bool acquire()
+    {
+        if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+        auto const previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & INDEX;
+        return true;
+    }
+
+    // Reader only, stays as it is until the next acquire()
+    [[nodiscard]] T const& front() const
+    {
+        return slots_[front_];
+    }
+
+private:
+    static constexpr uint8_t INDEX {0b011};
+    static constexpr uint8_t FRESH {0b100};
+
+    std::array<T, 3> slots_;
+    // Both sides write their own index and hit the shared one on every swap, keep them on separate lines
+    alignas(64) uint8_t back_{0};
+    alignas(64) std::atomic<uint8_t> middle_{1};
+    alignas(64) uint8_t front_{2};
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+enum class Block : uint16_t {
+    Air,
+    Stone,
+    Dirt,
+    Grass,
+    Sand,
+    Lamp,
+    MAX_COUNT
+};
+
+constexpr bool is_opaque(Block const block)
+{
+    return block != Block::Air;
+}
+
+// Layer of the block texture array a block is drawn with, air has none
+constexpr uint32_t texture_layer(Block const block)
+{
+    return static_cast<uint32_t>(block) - 1;
+}
+
+// One per block but air
+constexpr uint32_t TEXTURE_LAYERS {static_cast<uint32_t>(Block::MAX_COUNT) - 1};
+static_assert(TEXTURE_LAYERS <= 256, "Layers must fit the 8 bits PackedVertex has for them");
+
+// Block light given off by the block itself, up to 15
+constexpr uint8_t light_emission(Block const block)
+{
+    return block == Block::Lamp ? 14 : 0;
+}
+
+enum class Face : uint8_t {
+    PosX,
+    NegX,
+    PosY,
+    NegY,
+    PosZ,
+    NegZ,
+    MAX_COUNT
+};
+
+// 0 for x, 1 for y, 2 for z
+constexpr int face_axis(Face const face)
+{
+    return static_cast<int>(face) / 2;
+}
+
+constexpr int face_sign(Face const face)
+{
+    return static_cast<int>(face) % 2 == 0 ? 1 : -1;
+}
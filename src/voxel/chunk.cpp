@@ -0,0 +1,233 @@
+#include <algorithm>
+#include "voxel/chunk.hpp"
+
+namespace
+{
+
+constexpr size_t palette_capacity(uint8_t const bits)
+{
+    return size_t{1} << bits;
+}
+
+constexpr uint8_t bits_for(size_t const palette_size)
+{
+    uint8_t bits{0};
+    while (palette_capacity(bits) < palette_size)
+    {
+        bits = bits == 0 ? 1 : bits * 2;
+    }
+    return bits;
+}
+
+constexpr size_t words_for(uint8_t const bits)
+{
+    return SECTION_VOLUME * bits / 64;
+}
+
+} // namespace
+
+template <typename Layout>
+BasicChunkSection<Layout>::BasicChunkSection(Block const fill_with)
+{
+    fill(fill_with);
+}
+
+template <typename Layout>
+void BasicChunkSection<Layout>::fill(Block const block)
+{
+    palette_.assign(1, block);
+    std::vector<uint64_t>{}.swap(data_);
+    bits_ = 0;
+    non_air_ = block == Block::Air ? 0 : SECTION_VOLUME;
+}
+
+template <typename Layout>
+void BasicChunkSection<Layout>::set(int const x, int const y, int const z, Block const block)
+{
+    auto const idx = index(x, y, z);
+    auto const previous = palette_[read(idx)];
+    if (previous == block) return;
+
+    non_air_ += (block != Block::Air) - (previous != Block::Air);
+    if (non_air_ == 0)
+    {
+        fill(Block::Air);
+        return;
+    }
+    auto const value = palette_index(block);
+    write(idx, value);
+}
+
+template <typename Layout>
+void BasicChunkSection<Layout>::copy_row(int const y, int const z, int const from_x, int const to_x, Block* out) const
+{
+    if (bits_ == 0)
+    {
+        std::fill(out, out + (to_x - from_x), palette_[0]);
+        return;
+    }
+    if constexpr (not std::is_same_v<Layout, LinearLayout>)
+    {
+        for (int x{from_x}; x < to_x; ++x)
+        {
+            *out++ = palette_[read(index(x, y, z))];
+        }
+        return;
+    }
+    // Entries never straddle words, so a row is a few words shifted down entry by entry
+    auto const shift = std::countr_zero(bits_);
+    auto const per_word_log2 = 6 - shift;
+    auto const per_word_mask = (size_t{1} << per_word_log2) - 1;
+    auto const value_mask = mask();
+    auto idx = index(from_x, y, z);
+    auto word = data_[idx >> per_word_log2] >> ((idx & per_word_mask) << shift);
+    for (int x{from_x}; x < to_x; ++x)
+    {
+        *out++ = palette_[word & value_mask];
+        word >>= bits_;
+        if ((++idx & per_word_mask) == 0 and x + 1 < to_x) word = data_[idx >> per_word_log2];
+    }
+}
+
+template <typename Layout>
+void BasicChunkSection<Layout>::write(size_t const idx, uint16_t const value)
+{
+    if (bits_ == 0) return;
+    auto const shift = std::countr_zero(bits_);
+    auto const per_word_log2 = 6 - shift;
+    auto const offset = (idx & ((1u << per_word_log2) - 1)) << shift;
+    auto& word = data_[idx >> per_word_log2];
+    word = (word & ~(mask() << offset)) | (uint64_t{value} << offset);
+}
+
+template <typename Layout>
+uint16_t BasicChunkSection<Layout>::palette_index(Block const block)
+{
+    auto const found_it = std::find(palette_.begin(), palette_.end(), block);
+    if (found_it != palette_.end())
+    {
+        return static_cast<uint16_t>(std::distance(palette_.begin(), found_it));
+    }
+
+    if (palette_.size() == palette_capacity(bits_))
+    {
+        compact();
+    }
+    if (palette_.size() == palette_capacity(bits_))
+    {
+        repack(bits_for(palette_.size() + 1), {});
+    }
+    palette_.push_back(block);
+    return static_cast<uint16_t>(palette_.size() - 1);
+}
+
+template <typename Layout>
+void BasicChunkSection<Layout>::compact()
+{
+    if (bits_ == 0) return;
+
+    std::vector<uint32_t> usage(palette_.size(), 0);
+    for (size_t idx{}; idx < SECTION_VOLUME; ++idx)
+    {
+        ++usage[read(idx)];
+    }
+
+    std::vector<uint16_t> remap(palette_.size(), 0);
+    std::vector<Block> compacted;
+    for (size_t entry{}; entry < palette_.size(); ++entry)
+    {
+        if (usage[entry] == 0) continue;
+        remap[entry] = static_cast<uint16_t>(compacted.size());
+        compacted.push_back(palette_[entry]);
+    }
+    if (compacted.size() == palette_.size()) return;
+
+    repack(bits_for(compacted.size()), remap);
+    palette_ = std::move(compacted);
+}
+
+template <typename Layout>
+void BasicChunkSection<Layout>::repack(uint8_t const new_bits, std::span<uint16_t const> remap)
+{
+    std::array<uint16_t, SECTION_VOLUME> indices;
+    for (size_t idx{}; idx < SECTION_VOLUME; ++idx)
+    {
+        auto const value = read(idx);
+        indices[idx] = remap.empty() ? value : remap[value];
+    }
+
+    bits_ = new_bits;
+    data_ = std::vector<uint64_t>(words_for(bits_), 0);
+    for (size_t idx{}; idx < SECTION_VOLUME; ++idx)
+    {
+        write(idx, indices[idx]);
+    }
+}
+
+template <typename Layout>
+bool BasicChunkSection<Layout>::assign(uint8_t const bits, std::span<Block const> palette, std::span<uint64_t const> words)
+{
+    auto const valid_bits = bits == 0 or (std::has_single_bit(bits) and bits <= 16);
+    if (not valid_bits or palette.empty() or palette.size() > palette_capacity(bits) or words.size() != words_for(bits)) return false;
+    auto const known = [](Block const block) { return block < Block::MAX_COUNT; };
+    if (not std::ranges::all_of(palette, known)) return false;
+
+    BasicChunkSection loaded;
+    loaded.bits_ = bits;
+    loaded.palette_.assign(palette.begin(), palette.end());
+    loaded.data_.assign(words.begin(), words.end());
+    // Walks the words directly, going through read() for every block made this most of the load time
+    uint16_t non_air = bits == 0 and palette[0] != Block::Air ? SECTION_VOLUME : 0;
+    auto const mask = loaded.mask();
+    for (auto word : words)
+    {
+        for (int shift{}; shift < 64; shift += bits)
+        {
+            auto const value = word & mask;
+            word >>= bits;
+            if (value >= palette.size()) return false;
+            non_air += palette[value] != Block::Air;
+        }
+    }
+    loaded.non_air_ = non_air;
+    if (non_air == 0) loaded.fill(Block::Air);
+
+    *this = std::move(loaded);
+    return true;
+}
+
+template <typename Layout>
+size_t BasicChunkSection<Layout>::memory_usage() const
+{
+    return sizeof(*this) + palette_.capacity() * sizeof(Block) + data_.capacity() * sizeof(uint64_t);
+}
+
+template class BasicChunkSection<LinearLayout>;
+template class BasicChunkSection<MortonLayout>;
+
+Chunk::Chunk(ChunkPos const pos) :
+    pos_{pos}
+{}
+
+void Chunk::compact()
+{
+    for (auto& section : sections_)
+    {
+        section.compact();
+    }
+}
+
+bool Chunk::empty() const
+{
+    return std::ranges::all_of(sections_, [](auto const& section) { return section.empty(); });
+}
+
+size_t Chunk::memory_usage() const
+{
+    size_t total{sizeof(pos_) + light_.capacity()};
+    for (auto const& section : sections_)
+    {
+        total += section.memory_usage();
+    }
+    return total;
+}
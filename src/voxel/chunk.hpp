@@ -0,0 +1,254 @@
+#pragma once
+#include <array>
+#include <assert.h>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <vector>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+#include "voxel/block.hpp"
+
+constexpr int SECTION_SIZE {16};
+constexpr int SECTION_VOLUME {SECTION_SIZE * SECTION_SIZE * SECTION_SIZE};
+constexpr int SECTIONS_PER_CHUNK {8};
+constexpr int CHUNK_HEIGHT {SECTION_SIZE * SECTIONS_PER_CHUNK};
+constexpr int CHUNK_VOLUME {SECTION_VOLUME * SECTIONS_PER_CHUNK};
+// Light is a byte per block, sky light in the high nibble and block light in the low one
+constexpr uint8_t FULL_SKY_LIGHT {0xF0};
+
+struct ChunkPos
+{
+    int32_t x;
+    int32_t z;
+
+    auto operator<=>(ChunkPos const& other) const = default;
+};
+
+template <>
+struct std::hash<ChunkPos>
+{
+    size_t operator()(ChunkPos const pos) const noexcept
+    {
+        return std::hash<uint64_t>{}((static_cast<uint64_t>(static_cast<uint32_t>(pos.x)) << 32) | static_cast<uint32_t>(pos.z));
+    }
+};
+
+// Where a block of a section sits in its packed data. Every layout keeps a section in 4096 entries and
+// differs only in their order, palette and packing don't care.
+// Rows along x, then layers of rows. Rows decode in one go
+struct LinearLayout
+{
+    static constexpr uint8_t ID {0};
+
+    [[nodiscard]] static constexpr size_t index(int const x, int const y, int const z)
+    {
+        return static_cast<size_t>(x | (z << 4) | (y << 8));
+    }
+};
+
+// Z-order: bits of x, z and y interleaved, x lowest. Blocks close in 3D are mostly close in memory as well,
+// which is what walks in arbitrary directions (rays, collision) want. Rows are spread over the section though.
+// The bits are deposited with pdep in builds targeting BMI2 (section_layout morton_bmi2, or -mbmi2 in general),
+// with a table otherwise. pdep is microcoded and slow on AMD before Zen 3, the table isn't much slower anywhere
+struct MortonLayout
+{
+    static constexpr uint8_t ID {1};
+
+    [[nodiscard]] static constexpr size_t index(int const x, int const y, int const z)
+    {
+#ifdef __BMI2__
+        if (not std::is_constant_evaluated())
+        {
+            return _pdep_u32(static_cast<uint32_t>(x), 0x249) | _pdep_u32(static_cast<uint32_t>(z), 0x492) | _pdep_u32(static_cast<uint32_t>(y), 0x924);
+        }
+#endif
+        return SPREAD[static_cast<size_t>(x)] | (SPREAD[static_cast<size_t>(z)] << 1) | (SPREAD[static_cast<size_t>(y)] << 2);
+    }
+
+private:
+    // 4 bits moved 3 apart
+    static constexpr std::array<uint16_t, 16> SPREAD {
+        0x000, 0x001, 0x008, 0x009, 0x040, 0x041, 0x048, 0x049,
+        0x200, 0x201, 0x208, 0x209, 0x240, 0x241, 0x248, 0x249,
+    };
+};
+
+// The game uses one layout throughout, picked at build time (meson option section_layout)
+#ifdef MORTON_SECTIONS
+using SectionLayout = MortonLayout;
+#else
+using SectionLayout = LinearLayout;
+#endif
+
+// 16^3 blocks kept as indices into a small palette of distinct block types.
+// Indices are packed into 64 bit words with a power of two width (0, 1, 2, 4, 8 or 16 bits),
+// so a single entry never straddles two words and get/set stay a shift and a mask.
+// Section made of a single block type keeps no index data at all.
+// Layout orders the entries, see LinearLayout and MortonLayout.
+template <typename Layout>
+class BasicChunkSection
+{
+public:
+    using LayoutType = Layout;
+
+    explicit BasicChunkSection(Block const fill_with = Block::Air);
+
+    [[nodiscard]] Block get(int const x, int const y, int const z) const
+    {
+        return palette_[read(index(x, y, z))];
+    }
+
+    void set(int const x, int const y, int const z, Block const block);
+    void fill(Block const block);
+
+    // Blocks from_x up to to_x of the row at y z, without get()'s per block setup
+    void copy_row(int const y, int const z, int const from_x, int const to_x, Block* out) const;
+
+    // Drops palette entries which are no longer referenced, shrinking the bit width if possible.
+    // Called automatically before the palette would have to grow.
+    void compact();
+
+    [[nodiscard]] bool empty() const
+    {
+        return non_air_ == 0;
+    }
+
+    [[nodiscard]] bool uniform() const
+    {
+        return bits_ == 0;
+    }
+
+    [[nodiscard]] uint8_t bits() const
+    {
+        return bits_;
+    }
+
+    [[nodiscard]] std::span<Block const> palette() const
+    {
+        return palette_;
+    }
+
+    [[nodiscard]] std::span<uint64_t const> words() const
+    {
+        return data_;
+    }
+
+    // Takes over packed contents as given out by bits(), palette() and words(), e.g. read back from disk.
+    // Leaves the section untouched and returns false when they don't describe a valid section.
+    bool assign(uint8_t const bits, std::span<Block const> palette, std::span<uint64_t const> words);
+
+    [[nodiscard]] size_t memory_usage() const;
+
+    [[nodiscard]] static constexpr size_t index(int const x, int const y, int const z)
+    {
+        assert(x >= 0 and x < SECTION_SIZE and y >= 0 and y < SECTION_SIZE and z >= 0 and z < SECTION_SIZE);
+        return Layout::index(x, y, z);
+    }
+
+private:
+    [[nodiscard]] uint16_t read(size_t const idx) const
+    {
+        if (bits_ == 0) return 0;
+        auto const shift = std::countr_zero(bits_);
+        auto const per_word_log2 = 6 - shift;
+        auto const offset = (idx & ((1u << per_word_log2) - 1)) << shift;
+        return static_cast<uint16_t>((data_[idx >> per_word_log2] >> offset) & mask());
+    }
+
+    void write(size_t const idx, uint16_t const value);
+    [[nodiscard]] uint64_t mask() const
+    {
+        return (uint64_t{1} << bits_) - 1;
+    }
+
+    uint16_t palette_index(Block const block);
+    void repack(uint8_t const new_bits, std::span<uint16_t const> remap);
+
+    std::vector<Block> palette_;
+    std::vector<uint64_t> data_;
+    uint16_t non_air_{0};
+    uint8_t bits_{0};
+};
+
+extern template class BasicChunkSection<LinearLayout>;
+extern template class BasicChunkSection<MortonLayout>;
+
+using ChunkSection = BasicChunkSection<SectionLayout>;
+
+// Column of SECTIONS_PER_CHUNK sections, 16 x CHUNK_HEIGHT x 16 blocks.
+class Chunk
+{
+public:
+    explicit Chunk(ChunkPos const pos);
+
+    // Out of range heights read as air, so callers don't have to clip against the world bounds
+    [[nodiscard]] Block get(int const x, int const y, int const z) const
+    {
+        if (y < 0 or y >= CHUNK_HEIGHT) return Block::Air;
+        return sections_[y / SECTION_SIZE].get(x, y % SECTION_SIZE, z);
+    }
+
+    void set(int const x, int const y, int const z, Block const block)
+    {
+        assert(y >= 0 and y < CHUNK_HEIGHT);
+        sections_[y / SECTION_SIZE].set(x, y % SECTION_SIZE, z, block);
+    }
+
+    [[nodiscard]] ChunkSection const& section(size_t const idx) const
+    {
+        return sections_[idx];
+    }
+
+    [[nodiscard]] ChunkSection& section(size_t const idx)
+    {
+        return sections_[idx];
+    }
+
+    [[nodiscard]] ChunkPos pos() const
+    {
+        return pos_;
+    }
+
+    // Above the world is open sky and below it is dark. Chunks that were never lit read as open sky everywhere
+    [[nodiscard]] uint8_t light(int const x, int const y, int const z) const
+    {
+        if (y >= CHUNK_HEIGHT) return FULL_SKY_LIGHT;
+        if (y < 0) return 0;
+        return light_.empty() ? FULL_SKY_LIGHT : light_[light_index(x, y, z)];
+    }
+
+    // Light of every block in light_index order, allocated on first use
+    [[nodiscard]] std::span<uint8_t> light_data()
+    {
+        if (light_.empty()) light_.resize(CHUNK_VOLUME, FULL_SKY_LIGHT);
+        return light_;
+    }
+
+    // Empty while the chunk was never lit
+    [[nodiscard]] std::span<uint8_t const> light_data() const
+    {
+        return light_;
+    }
+
+    // x, then z, then y through the whole chunk, whatever the section layout is
+    [[nodiscard]] static constexpr size_t light_index(int const x, int const y, int const z)
+    {
+        assert(x >= 0 and x < SECTION_SIZE and y >= 0 and y < CHUNK_HEIGHT and z >= 0 and z < SECTION_SIZE);
+        return static_cast<size_t>(x | (z << 4) | (y << 8));
+    }
+
+    // Worth calling once after bulk edits like world generation
+    void compact();
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t memory_usage() const;
+
+private:
+    ChunkPos pos_;
+    std::array<ChunkSection, SECTIONS_PER_CHUNK> sections_;
+    std::vector<uint8_t> light_;
+};
@@ -0,0 +1,141 @@
+#include <bit>
+#include "voxel/chunk_map.hpp"
+
+namespace
+{
+
+constexpr size_t MIN_BUCKETS {16};
+
+size_t bucket_count_for(size_t const chunks)
+{
+    // Keeps the load factor at or below one half
+    return std::max(MIN_BUCKETS, std::bit_ceil(chunks * 2));
+}
+
+} // namespace
+
+ChunkMap::ChunkMap(size_t const expected_chunks) :
+    buckets_(bucket_count_for(expected_chunks)),
+    mask_{buckets_.size() - 1}
+{
+    slots_.reserve(expected_chunks);
+    loaded_.reserve(expected_chunks);
+    loaded_slots_.reserve(expected_chunks);
+}
+
+ChunkHandle ChunkMap::emplace(ChunkPos const pos)
+{
+    if (auto const existing = handle(pos); existing.valid()) return existing;
+
+    if ((loaded_.size() + 1) * 2 > buckets_.size())
+    {
+        grow();
+    }
+
+    uint32_t slot{};
+    if (free_slots_.empty())
+    {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+    else
+    {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    }
+
+    auto& entry = slots_[slot];
+    entry.chunk = std::make_unique<Chunk>(pos);
+    entry.dense = static_cast<uint32_t>(loaded_.size());
+    loaded_.push_back(entry.chunk.get());
+    loaded_slots_.push_back(slot);
+    insert_bucket(pos, slot);
+    return {slot, entry.generation};
+}
+
+void ChunkMap::insert_bucket(ChunkPos const pos, uint32_t const slot)
+{
+    auto idx = home(pos);
+    while (buckets_[idx].slot != EMPTY)
+    {
+        idx = (idx + 1) & mask_;
+    }
+    buckets_[idx] = {pos, slot};
+}
+
+bool ChunkMap::erase(ChunkPos const pos)
+{
+    auto idx = home(pos);
+    while (buckets_[idx].slot != EMPTY and buckets_[idx].pos != pos)
+    {
+        idx = (idx + 1) & mask_;
+    }
+    if (buckets_[idx].slot == EMPTY) return false;
+
+    auto const slot = buckets_[idx].slot;
+    auto& entry = slots_[slot];
+
+    // Swap remove from the dense array
+    auto const dense = entry.dense;
+    loaded_[dense] = loaded_.back();
+    loaded_slots_[dense] = loaded_slots_.back();
+    slots_[loaded_slots_[dense]].dense = dense;
+    loaded_.pop_back();
+    loaded_slots_.pop_back();
+
+    entry.chunk.reset();
+    ++entry.generation;
+    free_slots_.push_back(slot);
+
+    // Backward shift: pull following entries of the probe run into the hole,
+    // unless that would move them in front of their home bucket
+    auto hole = idx;
+    for (auto next = (hole + 1) & mask_; buckets_[next].slot != EMPTY; next = (next + 1) & mask_)
+    {
+        auto const desired = home(buckets_[next].pos);
+        auto const distance_to_hole = (hole - desired) & mask_;
+        auto const distance_to_next = (next - desired) & mask_;
+        if (distance_to_hole < distance_to_next)
+        {
+            buckets_[hole] = buckets_[next];
+            hole = next;
+        }
+    }
+    buckets_[hole] = {};
+    return true;
+}
+
+void ChunkMap::clear()
+{
+    std::fill(buckets_.begin(), buckets_.end(), Bucket{});
+    for (size_t slot{}; slot < slots_.size(); ++slot)
+    {
+        if (not slots_[slot].chunk) continue;
+        slots_[slot].chunk.reset();
+        ++slots_[slot].generation;
+        free_slots_.push_back(static_cast<uint32_t>(slot));
+    }
+    loaded_.clear();
+    loaded_slots_.clear();
+}
+
+void ChunkMap::grow()
+{
+    std::vector<Bucket> previous(buckets_.size() * 2);
+    previous.swap(buckets_);
+    mask_ = buckets_.size() - 1;
+    for (auto const& bucket : previous)
+    {
+        if (bucket.slot != EMPTY) insert_bucket(bucket.pos, bucket.slot);
+    }
+}
+
+size_t ChunkMap::memory_usage() const
+{
+    return sizeof(*this)
+        + buckets_.capacity() * sizeof(Bucket)
+        + slots_.capacity() * sizeof(Slot)
+        + free_slots_.capacity() * sizeof(uint32_t)
+        + loaded_.capacity() * sizeof(Chunk*)
+        + loaded_slots_.capacity() * sizeof(uint32_t);
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "voxel/chunk.hpp"
+
+// Survives rehashing and other chunks being unloaded, goes stale when its own chunk is erased
+struct ChunkHandle
+{
+    static constexpr uint32_t INVALID {std::numeric_limits<uint32_t>::max()};
+
+    uint32_t slot{INVALID};
+    uint32_t generation{0};
+
+    [[nodiscard]] bool valid() const
+    {
+        return slot != INVALID;
+    }
+
+    auto operator<=>(ChunkHandle const& other) const = default;
+};
+
+// Flat open-addressing table from chunk coordinates to loaded chunks.
+// Linear probing with backward shift deletion, so there are no tombstones to clean up.
+// Chunks in the same 4x4 tile hash to 16 consecutive buckets, neighbour lookups done
+// by meshing, lighting and collision then mostly stay within a few cache lines.
+// Chunks themselves are heap allocated once and never move while loaded.
+class ChunkMap
+{
+public:
+    explicit ChunkMap(size_t const expected_chunks = 256);
+
+    ChunkMap(ChunkMap const&) = delete;
+    ChunkMap& operator=(ChunkMap const&) = delete;
+
+    // Returns the already loaded chunk if there is one
+    ChunkHandle emplace(ChunkPos const pos);
+    bool erase(ChunkPos const pos);
+    void clear();
+
+    [[nodiscard]] Chunk* get(ChunkPos const pos)
+    {
+        auto const slot = find_slot(pos);
+        return slot == ChunkHandle::INVALID ? nullptr : slots_[slot].chunk.get();
+    }
+
+    [[nodiscard]] Chunk const* get(ChunkPos const pos) const
+    {
+        auto const slot = find_slot(pos);
+        return slot == ChunkHandle::INVALID ? nullptr : slots_[slot].chunk.get();
+    }
+
+    [[nodiscard]] ChunkHandle handle(ChunkPos const pos) const
+    {
+        auto const slot = find_slot(pos);
+        if (slot == ChunkHandle::INVALID) return {};
+        return {slot, slots_[slot].generation};
+    }
+
+    // nullptr for stale handles
+    [[nodiscard]] Chunk* get(ChunkHandle const handle)
+    {
+        if (handle.slot >= slots_.size() or slots_[handle.slot].generation != handle.generation) return nullptr;
+        return slots_[handle.slot].chunk.get();
+    }
+
+    [[nodiscard]] bool contains(ChunkPos const pos) const
+    {
+        return find_slot(pos) != ChunkHandle::INVALID;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return loaded_.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return loaded_.empty();
+    }
+
+    // Iterates over a dense array of the loaded chunks, in no particular order
+    [[nodiscard]] auto begin() const
+    {
+        return loaded_.begin();
+    }
+
+    [[nodiscard]] auto end() const
+    {
+        return loaded_.end();
+    }
+
+    [[nodiscard]] size_t memory_usage() const;
+
+private:
+    static constexpr uint32_t EMPTY {ChunkHandle::INVALID};
+
+    struct Bucket
+    {
+        ChunkPos pos;
+        uint32_t slot{EMPTY};
+    };
+
+    struct Slot
+    {
+        std::unique_ptr<Chunk> chunk;
+        uint32_t generation{0};
+        uint32_t dense{0};
+    };
+
+    [[nodiscard]] size_t home(ChunkPos const pos) const
+    {
+        // Low 4 bits pick the position inside a 4x4 tile, the rest is a fibonacci hash of the tile
+        auto const tile = (static_cast<uint64_t>(static_cast<uint32_t>(pos.x >> 2)) << 32)
+            | static_cast<uint32_t>(pos.z >> 2);
+        auto const tile_hash = (tile * 0x9E3779B97F4A7C15ull) >> 32;
+        auto const in_tile = static_cast<uint64_t>((pos.x & 3) | ((pos.z & 3) << 2));
+        return ((tile_hash << 4) | in_tile) & mask_;
+    }
+
+    [[nodiscard]] uint32_t find_slot(ChunkPos const pos) const
+    {
+        for (auto idx = home(pos);; idx = (idx + 1) & mask_)
+        {
+            auto const& bucket = buckets_[idx];
+            if (bucket.slot == EMPTY or bucket.pos == pos) return bucket.slot;
+        }
+    }
+
+    void insert_bucket(ChunkPos const pos, uint32_t const slot);
+    void grow();
+
+    std::vector<Bucket> buckets_;
+    size_t mask_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+    std::vector<Chunk*> loaded_;
+    std::vector<uint32_t> loaded_slots_;
+};
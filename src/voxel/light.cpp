@@ -0,0 +1,338 @@
+#include <algorithm>
+#include "voxel/light.hpp"
+
+namespace
+{
+
+// Where a channel sits in the light byte
+constexpr int SKY {4};
+constexpr int BLOCK {0};
+constexpr uint8_t MAX_LIGHT {15};
+
+// Offsets in Face order
+constexpr std::array<std::array<int, 3>, 6> DIRECTIONS {{
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1},
+}};
+
+template <int SHIFT>
+uint8_t level_of(uint8_t const value)
+{
+    return (value >> SHIFT) & 15;
+}
+
+template <int SHIFT>
+uint8_t with_level(uint8_t const value, uint8_t const level)
+{
+    return static_cast<uint8_t>((value & ~(15 << SHIFT)) | (level << SHIFT));
+}
+
+// What a block at level passes on to its neighbour in direction face, level has to be at least 1
+template <int SHIFT>
+uint8_t passed_on(uint8_t const level, Face const face)
+{
+    if (SHIFT == SKY and face == Face::NegY and level == MAX_LIGHT) return MAX_LIGHT;
+    return static_cast<uint8_t>(level - 1);
+}
+
+} // namespace
+
+LightArea LightEngine::area(ChunkMap& chunks, ChunkPos const center)
+{
+    LightArea result{};
+    for (int dz{-1}; dz <= 1; ++dz)
+    {
+        for (int dx{-1}; dx <= 1; ++dx)
+        {
+            result[static_cast<size_t>((dz + 1) * 3 + dx + 1)] = chunks.get(ChunkPos{center.x + dx, center.z + dz});
+        }
+    }
+    return result;
+}
+
+void LightEngine::light_chunk(Chunk& chunk)
+{
+    // Nothing around, the fills stop at the chunk's borders
+    LightArea alone{};
+    alone[MIDDLE] = &chunk;
+    begin(alone);
+    auto* light = lights_[MIDDLE];
+
+    // Everything above the highest section with blocks in it is open sky
+    int top{0};
+    for (int idx{SECTIONS_PER_CHUNK - 1}; idx >= 0; --idx)
+    {
+        if (chunk.section(static_cast<size_t>(idx)).empty()) continue;
+        top = (idx + 1) * SECTION_SIZE;
+        break;
+    }
+    auto* sky_start = light + top * SECTION_SIZE * SECTION_SIZE;
+    std::fill(light, sky_start, 0);
+    std::fill(sky_start, light + CHUNK_VOLUME, FULL_SKY_LIGHT);
+
+    // Straight down every column to the first opaque block
+    std::array<int, SECTION_SIZE * SECTION_SIZE> lit_down_to{};
+    for (int z{}; z < SECTION_SIZE; ++z)
+    {
+        for (int x{}; x < SECTION_SIZE; ++x)
+        {
+            auto y = top - 1;
+            for (; y >= 0 and not is_opaque(chunk.get(x, y, z)); --y)
+            {
+                light[Chunk::light_index(x, y, z)] = FULL_SKY_LIGHT;
+            }
+            lit_down_to[z * SECTION_SIZE + x] = y + 1;
+        }
+    }
+
+    // Sunlit blocks next to a column that is covered at their height light it from the side
+    for (int z{}; z < SECTION_SIZE; ++z)
+    {
+        for (int x{}; x < SECTION_SIZE; ++x)
+        {
+            for (auto const face : {Face::PosX, Face::NegX, Face::PosZ, Face::NegZ})
+            {
+                auto const& offset = DIRECTIONS[static_cast<size_t>(face)];
+                auto const next_x = x + offset[0];
+                auto const next_z = z + offset[2];
+                if (next_x < 0 or next_x >= SECTION_SIZE or next_z < 0 or next_z >= SECTION_SIZE) continue;
+                for (int y{lit_down_to[z * SECTION_SIZE + x]}; y < lit_down_to[next_z * SECTION_SIZE + next_x]; ++y)
+                {
+                    refill_.push_back({MIDDLE, 0, static_cast<uint16_t>(Chunk::light_index(x, y, z))});
+                }
+            }
+        }
+    }
+    spread<SKY>(refill_);
+
+    // Only sections with an emitter in their palette need a closer look
+    for (size_t idx{}; idx < SECTIONS_PER_CHUNK; ++idx)
+    {
+        auto const& section = chunk.section(idx);
+        auto const emits = [](Block const block) { return light_emission(block) > 0; };
+        if (std::ranges::none_of(section.palette(), emits)) continue;
+
+        auto const base = static_cast<int>(idx) * SECTION_SIZE;
+        for (int y{}; y < SECTION_SIZE; ++y)
+        {
+            for (int z{}; z < SECTION_SIZE; ++z)
+            {
+                for (int x{}; x < SECTION_SIZE; ++x)
+                {
+                    auto const emitted = light_emission(section.get(x, y, z));
+                    if (emitted == 0) continue;
+                    auto const index = static_cast<uint16_t>(Chunk::light_index(x, base + y, z));
+                    light[index] = with_level<BLOCK>(light[index], emitted);
+                    refill_.push_back({MIDDLE, 0, index});
+                }
+            }
+        }
+    }
+    spread<BLOCK>(refill_);
+
+    // Nobody else sees the chunk yet, nothing to remesh
+    touched_.clear();
+}
+
+void LightEngine::stitch(LightArea const& area)
+{
+    if (area[MIDDLE] == nullptr) return;
+    begin(area);
+    auto const* inside = lights_[MIDDLE];
+
+    // Seeds the brighter side of every border pair that differs by more than a step, per channel
+    auto const seed = [](uint8_t const a, uint8_t const b, Node const& a_node, Node const& b_node, std::vector<Node>& queue) {
+        if (a > b + 1) queue.push_back(a_node);
+        else if (b > a + 1) queue.push_back(b_node);
+    };
+    for (auto const face : {Face::PosX, Face::NegX, Face::PosZ, Face::NegZ})
+    {
+        auto const& offset = DIRECTIONS[static_cast<size_t>(face)];
+        auto const slot = static_cast<uint8_t>(MIDDLE + offset[2] * 3 + offset[0]);
+        auto const* outside = lights_[slot];
+        if (outside == nullptr) continue;
+
+        constexpr int last {SECTION_SIZE - 1};
+        for (int along{}; along < SECTION_SIZE; ++along)
+        {
+            auto const x = offset[0] > 0 ? last : offset[0] < 0 ? 0 : along;
+            auto const z = offset[2] > 0 ? last : offset[2] < 0 ? 0 : along;
+            auto const inside_index = Chunk::light_index(x, 0, z);
+            auto const outside_index = Chunk::light_index((x + offset[0]) & 15, 0, (z + offset[2]) & 15);
+            for (int y{}; y < CHUNK_VOLUME; y += SECTION_SIZE * SECTION_SIZE)
+            {
+                auto const a = inside[inside_index + y];
+                auto const b = outside[outside_index + y];
+                if (a == b) continue;
+                Node const a_node {MIDDLE, 0, static_cast<uint16_t>(inside_index + y)};
+                Node const b_node {slot, 0, static_cast<uint16_t>(outside_index + y)};
+                seed(level_of<SKY>(a), level_of<SKY>(b), a_node, b_node, refill_);
+                seed(level_of<BLOCK>(a), level_of<BLOCK>(b), a_node, b_node, block_refill_);
+            }
+        }
+    }
+
+    spread<SKY>(refill_);
+    spread<BLOCK>(block_refill_);
+}
+
+void LightEngine::block_changed(LightArea const& area, int const x, int const y, int const z)
+{
+    if (area[MIDDLE] == nullptr or y < 0 or y >= CHUNK_HEIGHT) return;
+    begin(area);
+
+    Node const at {MIDDLE, 0, static_cast<uint16_t>(Chunk::light_index(x, y, z))};
+    relight<SKY>(at);
+    relight<BLOCK>(at);
+}
+
+void LightEngine::begin(LightArea const& area)
+{
+    area_ = area;
+    for (size_t slot{}; slot < area.size(); ++slot)
+    {
+        lights_[slot] = area[slot] == nullptr ? nullptr : area[slot]->light_data().data();
+    }
+    last_touched_ = NONE;
+}
+
+// Floods light out of every queued block, the queue ends up empty
+template <int SHIFT>
+void LightEngine::spread(std::vector<Node>& queue)
+{
+    for (size_t head{}; head < queue.size(); ++head)
+    {
+        auto const node = queue[head];
+        auto const level = level_of<SHIFT>(light(node));
+        if (level <= 1) continue;
+        for (uint8_t face{}; face < static_cast<uint8_t>(Face::MAX_COUNT); ++face)
+        {
+            auto const next = step(node, static_cast<Face>(face));
+            if (next.slot == NONE or is_opaque(block(next))) continue;
+            auto const target = passed_on<SHIFT>(level, static_cast<Face>(face));
+            auto& value = light(next);
+            if (level_of<SHIFT>(value) >= target) continue;
+            value = with_level<SHIFT>(value, target);
+            touch(next);
+            queue.push_back(next);
+        }
+    }
+    queue.clear();
+}
+
+// Clears the light that came from the blocks in the removal queue. Neighbours which are at least as
+// bright have a source of their own and go to the refill queue, to flow back into the cleared blocks
+template <int SHIFT>
+void LightEngine::unspread()
+{
+    for (size_t head{}; head < removal_.size(); ++head)
+    {
+        auto const node = removal_[head];
+        for (uint8_t face{}; face < static_cast<uint8_t>(Face::MAX_COUNT); ++face)
+        {
+            auto const next = step(node, static_cast<Face>(face));
+            if (next.slot == NONE) continue;
+            auto& value = light(next);
+            auto const level = level_of<SHIFT>(value);
+            if (level == 0) continue;
+            if (level > passed_on<SHIFT>(node.level, static_cast<Face>(face)))
+            {
+                refill_.push_back(next);
+                continue;
+            }
+
+            // Emitters lose what they got from around, never their own light
+            uint8_t const emitted = SHIFT == BLOCK ? light_emission(block(next)) : 0;
+            value = with_level<SHIFT>(value, emitted);
+            touch(next);
+            removal_.push_back({next.slot, level, next.index});
+            if (emitted > 0) refill_.push_back(next);
+        }
+    }
+    removal_.clear();
+}
+
+template <int SHIFT>
+void LightEngine::relight(Node const& at)
+{
+    // Whatever the block had goes, along with everything that got it from there
+    auto const previous = level_of<SHIFT>(light(at));
+    light(at) = with_level<SHIFT>(light(at), 0);
+    touch(at);
+    if (previous > 0)
+    {
+        removal_.push_back({at.slot, previous, at.index});
+        unspread<SHIFT>();
+    }
+
+    auto const current = block(at);
+    if (SHIFT == BLOCK and light_emission(current) > 0)
+    {
+        light(at) = with_level<SHIFT>(light(at), light_emission(current));
+        refill_.push_back(at);
+    }
+    if (not is_opaque(current))
+    {
+        // Light around flows into the block again
+        for (uint8_t face{}; face < static_cast<uint8_t>(Face::MAX_COUNT); ++face)
+        {
+            auto const next = step(at, static_cast<Face>(face));
+            if (next.slot != NONE) refill_.push_back(next);
+        }
+        if (SHIFT == SKY and at.index >> 8 == CHUNK_HEIGHT - 1)
+        {
+            light(at) = with_level<SHIFT>(light(at), MAX_LIGHT);
+            refill_.push_back(at);
+        }
+    }
+    spread<SHIFT>(refill_);
+}
+
+LightEngine::Node LightEngine::step(Node const& node, Face const face) const
+{
+    auto const& offset = DIRECTIONS[static_cast<size_t>(face)];
+    auto const x = (node.index & 15) + offset[0];
+    auto const y = (node.index >> 8) + offset[1];
+    auto const z = ((node.index >> 4) & 15) + offset[2];
+    if (y < 0 or y >= CHUNK_HEIGHT) return {};
+    if (x >= 0 and x < SECTION_SIZE and z >= 0 and z < SECTION_SIZE)
+    {
+        return {node.slot, 0, static_cast<uint16_t>(Chunk::light_index(x, y, z))};
+    }
+
+    // Over a border, the area ends one chunk away from the middle
+    auto const dx = node.slot % 3 - 1 + (x >> 4);
+    auto const dz = node.slot / 3 - 1 + (z >> 4);
+    if (dx < -1 or dx > 1 or dz < -1 or dz > 1) return {};
+    auto const slot = static_cast<uint8_t>((dz + 1) * 3 + dx + 1);
+    if (area_[slot] == nullptr) return {};
+    return {slot, 0, static_cast<uint16_t>(Chunk::light_index(x & 15, y, z & 15))};
+}
+
+uint8_t& LightEngine::light(Node const& node) const
+{
+    return lights_[node.slot][node.index];
+}
+
+Block LightEngine::block(Node const& node) const
+{
+    return area_[node.slot]->get(node.index & 15, node.index >> 8, (node.index >> 4) & 15);
+}
+
+void LightEngine::touch(Node const& node)
+{
+    auto const x = node.index & 15;
+    auto const z = (node.index >> 4) & 15;
+    auto const border = x == 0 or x == SECTION_SIZE - 1 or z == 0 or z == SECTION_SIZE - 1;
+    if (node.slot == last_touched_ and not border) return;
+    last_touched_ = node.slot;
+
+    auto const add = [this](ChunkPos const pos) {
+        if (std::ranges::find(touched_, pos) == touched_.end()) touched_.push_back(pos);
+    };
+    auto const pos = area_[node.slot]->pos();
+    add(pos);
+    if (x == 0) add({pos.x - 1, pos.z});
+    if (x == SECTION_SIZE - 1) add({pos.x + 1, pos.z});
+    if (z == 0) add({pos.x, pos.z - 1});
+    if (z == SECTION_SIZE - 1) add({pos.x, pos.z + 1});
+}
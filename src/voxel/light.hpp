@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <span>
+#include <vector>
+#include "voxel/chunk_map.hpp"
+
+// A chunk and its 8 neighbours, nullptr where nothing is loaded. Row by row, slot (dz + 1) * 3 + (dx + 1)
+using LightArea = std::array<Chunk*, 9>;
+
+// Sky light and block light, 4 bits each per block, spread by breadth first flood fills.
+// Sky light comes in from above at full strength and keeps it going straight down, every other step
+// costs a level. Block light starts at emitting blocks.
+// A chunk is first lit on its own as if everything around it was dark, stitch() then lets light flow
+// over its borders. Block edits relight incrementally: light that came from the changed block is flooded
+// out, the hole is refilled from the light around it, and only cells whose level changes are visited.
+// Light never travels more than 15 blocks sideways, so stitching the middle chunk of an area or editing
+// a block in it never reaches past the area. The engine only sees the area, never the chunk map, so it
+// runs fine on jobs as long as nothing else uses the area's chunks meanwhile.
+// Keeps its queues between calls, one engine per thread.
+class LightEngine
+{
+public:
+    [[nodiscard]] static LightArea area(ChunkMap& chunks, ChunkPos const center);
+
+    // Touches nothing but the chunk
+    void light_chunk(Chunk& chunk);
+    void stitch(LightArea const& area);
+    // Call after the block at x y z of the middle chunk changed
+    void block_changed(LightArea const& area, int const x, int const y, int const z);
+
+    // Chunks whose light changed since the last clear, and neighbours of changed border blocks,
+    // their meshes show light from across the border
+    [[nodiscard]] std::span<ChunkPos const> touched() const
+    {
+        return touched_;
+    }
+
+    void clear_touched()
+    {
+        touched_.clear();
+    }
+
+private:
+    static constexpr uint8_t MIDDLE {4};
+    // Slot of blocks past the area or the world
+    static constexpr uint8_t NONE {0xFF};
+
+    // A block in a flood fill queue
+    struct Node
+    {
+        // Index into the area
+        uint8_t slot{NONE};
+        // Level before it was removed, only used by removal queues
+        uint8_t level{0};
+        // Chunk::light_index of the block
+        uint16_t index{0};
+    };
+
+    void begin(LightArea const& area);
+    [[nodiscard]] Node step(Node const& node, Face const face) const;
+    [[nodiscard]] uint8_t& light(Node const& node) const;
+    [[nodiscard]] Block block(Node const& node) const;
+    void touch(Node const& node);
+
+    template <int SHIFT>
+    void spread(std::vector<Node>& queue);
+    template <int SHIFT>
+    void unspread();
+    template <int SHIFT>
+    void relight(Node const& at);
+
+    LightArea area_{};
+    std::array<uint8_t*, 9> lights_{};
+    std::vector<Node> removal_;
+    std::vector<Node> refill_;
+    // Stitching seeds both channels in one pass
+    std::vector<Node> block_refill_;
+    std::vector<ChunkPos> touched_;
+    uint8_t last_touched_{NONE};
+};
@@ -0,0 +1,323 @@
+#include <bit>
+#include <bitset>
+#include <chrono>
+#include "voxel/mesher.hpp"
+
+namespace
+{
+
+constexpr std::array<int, 3> DIMENSIONS {SECTION_SIZE, CHUNK_HEIGHT, SECTION_SIZE};
+
+static_assert(SECTION_SIZE <= 31 and CHUNK_HEIGHT <= 511, "Chunk local positions must fit PackedVertex");
+
+// Faces only merge when their block, light and occlusion match, so cells of the face slices hold all three
+constexpr uint32_t NO_FACE {0};
+
+constexpr uint32_t face_cell(Block const block, uint8_t const light, uint8_t const occlusion)
+{
+    return static_cast<uint32_t>(block) | (uint32_t{light} << 16) | (uint32_t{occlusion} << 24);
+}
+
+// Corners are (0, 0), (1, 0), (1, 1), (0, 1) in u v, unoccluded is 3
+constexpr uint32_t corner_occlusion(uint32_t const cell, int const corner)
+{
+    return (cell >> (24 + 2 * corner)) & 3;
+}
+
+// Merging keeps occlusion exact as long as it only changes across the merged direction, never along it
+constexpr bool merges_along_u(uint32_t const cell)
+{
+    return corner_occlusion(cell, 0) == corner_occlusion(cell, 1) and corner_occlusion(cell, 3) == corner_occlusion(cell, 2);
+}
+
+constexpr bool merges_along_v(uint32_t const cell)
+{
+    return corner_occlusion(cell, 0) == corner_occlusion(cell, 3) and corner_occlusion(cell, 1) == corner_occlusion(cell, 2);
+}
+
+} // namespace
+
+ChunkMesher::ChunkMesher() :
+    faces_(SECTION_SIZE * SECTION_SIZE * CHUNK_HEIGHT, NO_FACE)
+{
+    for (auto& visible : visible_)
+    {
+        visible.resize(SECTION_SIZE * SECTION_SIZE * COLUMN_WORDS);
+    }
+}
+
+MeshStats ChunkMesher::mesh(ChunkMap const& chunks, Chunk const& chunk, ChunkMesh& out)
+{
+    return mesh(chunk, ChunkNeighbourhood::neighbours(chunks, chunk.pos()), out);
+}
+
+MeshStats ChunkMesher::mesh(Chunk const& chunk, ChunkNeighbourhood::Neighbours const& neighbours, ChunkMesh& out)
+{
+    auto const start = Clock::now();
+    neighbourhood_.copy(chunk, neighbours);
+    auto const copy_milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    auto stats = mesh(neighbourhood_, out);
+    stats.copy_milliseconds = copy_milliseconds;
+    stats.milliseconds += copy_milliseconds;
+    return stats;
+}
+
+MeshStats ChunkMesher::mesh(ChunkNeighbourhood const& area, ChunkMesh& out)
+{
+    auto const start = Clock::now();
+
+    out.pos = area.pos();
+    ++out.revision;
+    out.vertices.clear();
+    out.indices.clear();
+
+    MeshStats stats{};
+    cull(area);
+    stats.cull_milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    for (uint8_t face{}; face < static_cast<uint8_t>(Face::MAX_COUNT); ++face)
+    {
+        mesh_face(area, static_cast<Face>(face), out, stats);
+    }
+    stats.vertices = static_cast<uint32_t>(out.vertices.size());
+    stats.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return stats;
+}
+
+void ChunkMesher::cull(ChunkNeighbourhood const& area)
+{
+    auto const face_index = [](Face const face) { return static_cast<size_t>(face); };
+    auto* pos_x = visible_[face_index(Face::PosX)].data();
+    auto* neg_x = visible_[face_index(Face::NegX)].data();
+    auto* pos_y = visible_[face_index(Face::PosY)].data();
+    auto* neg_y = visible_[face_index(Face::NegY)].data();
+    auto* pos_z = visible_[face_index(Face::PosZ)].data();
+    auto* neg_z = visible_[face_index(Face::NegZ)].data();
+
+    // Rows of columns are contiguous in x, so every loop body here is plain bitwise work on arrays
+    for (int z{}; z < SECTION_SIZE; ++z)
+    {
+        for (int x{}; x < SECTION_SIZE; ++x)
+        {
+            auto const* self = area.opaque(x, z);
+            auto const* right = area.opaque(x + 1, z);
+            auto const* left = area.opaque(x - 1, z);
+            auto const* front = area.opaque(x, z + 1);
+            auto const* back = area.opaque(x, z - 1);
+            auto const out = static_cast<size_t>(z * SECTION_SIZE + x) * COLUMN_WORDS;
+
+            for (int word{}; word < COLUMN_WORDS; ++word)
+            {
+                auto const blocks = self[word];
+                auto const above = (blocks >> 1) | (word + 1 < COLUMN_WORDS ? self[word + 1] << 63 : 0);
+                // Nothing is visible from below the world
+                auto const below = (blocks << 1) | (word > 0 ? self[word - 1] >> 63 : 1);
+
+                pos_x[out + word] = blocks & ~right[word];
+                neg_x[out + word] = blocks & ~left[word];
+                pos_y[out + word] = blocks & ~above;
+                neg_y[out + word] = blocks & ~below;
+                pos_z[out + word] = blocks & ~front[word];
+                neg_z[out + word] = blocks & ~back[word];
+            }
+        }
+    }
+}
+
+ChunkMesher::Occlusion ChunkMesher::occlusion(ChunkNeighbourhood const& area, int const x, int const z, int const word, Face const face)
+{
+    auto const axis = face_axis(face);
+    auto const u = (axis + 1) % 3;
+    auto const v = (axis + 2) % 3;
+
+    // Bit i says whether the block at the offset from block i of the word is solid, nothing is above or below the world
+    auto const sample = [&](int const du, int const dv) {
+        std::array<int, 3> offset{};
+        offset[axis] = face_sign(face);
+        offset[u] += du;
+        offset[v] += dv;
+        auto const* words = area.opaque(x + offset[0], z + offset[2]);
+        auto const bits = words[word];
+        if (offset[1] > 0) return (bits >> 1) | (word + 1 < COLUMN_WORDS ? words[word + 1] << 63 : 0);
+        if (offset[1] < 0) return (bits << 1) | (word > 0 ? words[word - 1] >> 63 : 0);
+        return bits;
+    };
+    std::array const side_u {sample(-1, 0), sample(1, 0)};
+    std::array const side_v {sample(0, -1), sample(0, 1)};
+
+    // 3 minus the solid blocks out of the two sides and the corner, as a 2 bit subtraction per bit.
+    // Two solid sides hide the corner block, the corner is fully dark either way
+    constexpr std::array<std::array<size_t, 2>, 4> CORNERS {{{0, 0}, {1, 0}, {1, 1}, {0, 1}}};
+    Occlusion result{};
+    result.open = ~(side_u[0] | side_u[1] | side_v[0] | side_v[1]);
+    for (size_t idx{}; idx < CORNERS.size(); ++idx)
+    {
+        auto const [along_u, along_v] = CORNERS[idx];
+        auto const a = side_u[along_u];
+        auto const b = side_v[along_v];
+        auto const c = sample(static_cast<int>(along_u) * 2 - 1, static_cast<int>(along_v) * 2 - 1);
+        result.low[idx] = ~(a ^ b ^ c) & ~(a & b);
+        result.high[idx] = ~((a & b) | (c & (a ^ b)));
+        result.open &= ~c;
+    }
+    return result;
+}
+
+void ChunkMesher::mesh_face(ChunkNeighbourhood const& area, Face const face, ChunkMesh& out, MeshStats& stats)
+{
+    auto const axis = face_axis(face);
+    auto const u = (axis + 1) % 3;
+    auto const v = (axis + 2) % 3;
+    auto const width = DIMENSIONS[u];
+    auto const height = DIMENSIONS[v];
+    auto const& visible = visible_[static_cast<size_t>(face)];
+
+    // Scatter visible faces into their slices, touching only set bits
+    std::bitset<CHUNK_HEIGHT> used_slices;
+    for (int z{}; z < SECTION_SIZE; ++z)
+    {
+        for (int x{}; x < SECTION_SIZE; ++x)
+        {
+            auto const first = static_cast<size_t>(z * SECTION_SIZE + x) * COLUMN_WORDS;
+            for (int word{}; word < COLUMN_WORDS; ++word)
+            {
+                if (visible[first + word] == 0) continue;
+                auto const planes = occlusion(area, x, z, word, face);
+                for (auto bits = visible[first + word]; bits != 0; bits &= bits - 1)
+                {
+                    auto const bit = std::countr_zero(bits);
+                    std::array const pos {x, word * 64 + bit, z};
+                    uint8_t occluded{0xFF};
+                    if (((planes.open >> bit) & 1) == 0)
+                    {
+                        occluded = 0;
+                        for (size_t corner{}; corner < 4; ++corner)
+                        {
+                            auto const level = ((planes.low[corner] >> bit) & 1) | ((planes.high[corner] >> bit) & 1) << 1;
+                            occluded = static_cast<uint8_t>(occluded | level << (2 * corner));
+                        }
+                    }
+                    // Lit by the block in front
+                    auto front = pos;
+                    front[axis] += face_sign(face);
+                    auto const light = area.light(front[0], front[1], front[2]);
+                    auto const cell = face_cell(area.block(pos[0], pos[1], pos[2]), light, occluded);
+                    faces_[(pos[axis] * height + pos[v]) * width + pos[u]] = cell;
+                    used_slices.set(static_cast<size_t>(pos[axis]));
+                    ++stats.faces;
+                }
+            }
+        }
+    }
+
+    for (int slice{}; slice < DIMENSIONS[axis]; ++slice)
+    {
+        if (used_slices.test(static_cast<size_t>(slice))) merge_slice(face, slice, out, stats);
+    }
+}
+
+// Grows each quad along u first, then along v for as long as whole rows match.
+// Consumed cells are reset to NO_FACE, so the scratch slice is clean for the next chunk.
+void ChunkMesher::merge_slice(Face const face, int const slice, ChunkMesh& out, MeshStats& stats)
+{
+    auto const axis = face_axis(face);
+    auto const u = (axis + 1) % 3;
+    auto const v = (axis + 2) % 3;
+    auto const width = DIMENSIONS[u];
+    auto const height = DIMENSIONS[v];
+    auto* cells = faces_.data() + static_cast<size_t>(slice * width * height);
+
+    for (int j{}; j < height; ++j)
+    {
+        for (int i{}; i < width;)
+        {
+            auto const cell = cells[j * width + i];
+            if (cell == NO_FACE)
+            {
+                ++i;
+                continue;
+            }
+
+            int quad_width{1};
+            while (merges_along_u(cell) and i + quad_width < width and cells[j * width + i + quad_width] == cell)
+            {
+                ++quad_width;
+            }
+
+            int quad_height{1};
+            for (; merges_along_v(cell) and j + quad_height < height; ++quad_height)
+            {
+                auto const row = (j + quad_height) * width + i;
+                bool matches{true};
+                for (int k{}; k < quad_width and matches; ++k)
+                {
+                    matches = cells[row + k] == cell;
+                }
+                if (not matches) break;
+            }
+
+            for (int dj{}; dj < quad_height; ++dj)
+            {
+                std::fill_n(cells + (j + dj) * width + i, quad_width, NO_FACE);
+            }
+
+            std::array<int, 3> base{};
+            base[axis] = slice + (face_sign(face) > 0 ? 1 : 0);
+            base[u] = i;
+            base[v] = j;
+            emit_quad(face, base, quad_width, quad_height, cell, out);
+            ++stats.quads;
+            i += quad_width;
+        }
+    }
+}
+
+void ChunkMesher::emit_quad(
+    Face const face,
+    std::array<int, 3> const& base,
+    int const width,
+    int const height,
+    uint32_t const cell,
+    ChunkMesh& out)
+{
+    auto const axis = face_axis(face);
+    auto const u = (axis + 1) % 3;
+    auto const v = (axis + 2) % 3;
+    auto const layer = texture_layer(static_cast<Block>(cell & 0xFFFF));
+    auto const sky_light = (cell >> 20) & 15;
+    auto const block_light = (cell >> 16) & 15;
+
+    auto const corner = [&](int const along_u, int const along_v) {
+        auto pos = base;
+        pos[u] += along_u;
+        pos[v] += along_v;
+        glm::uvec3 const local {static_cast<uint32_t>(pos[0]), static_cast<uint32_t>(pos[1]), static_cast<uint32_t>(pos[2])};
+        auto const occluded = corner_occlusion(cell, along_u == 0 ? (along_v == 0 ? 0 : 3) : (along_v == 0 ? 1 : 2));
+        return PackedVertex::pack(local, static_cast<uint32_t>(face), layer, occluded, sky_light, block_light);
+    };
+
+    auto const first = static_cast<uint32_t>(out.vertices.size());
+    // Counter clockwise when looking at the face from outside
+    if (face_sign(face) > 0)
+    {
+        out.vertices.insert(out.vertices.end(), {corner(0, 0), corner(width, 0), corner(width, height), corner(0, height)});
+    }
+    else
+    {
+        out.vertices.insert(out.vertices.end(), {corner(0, 0), corner(0, height), corner(width, height), corner(width, 0)});
+    }
+
+    // Both orders split the quad between (0, 0) and (width, height). Interpolation smears the corners on the
+    // split across both triangles, so the split goes through the darker pair, or occlusion looks lopsided
+    auto const split = corner_occlusion(cell, 0) + corner_occlusion(cell, 2);
+    auto const other = corner_occlusion(cell, 1) + corner_occlusion(cell, 3);
+    if (split <= other)
+    {
+        out.indices.insert(out.indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+    }
+    else
+    {
+        out.indices.insert(out.indices.end(), {first + 1, first + 2, first + 3, first + 1, first + 3, first});
+    }
+}
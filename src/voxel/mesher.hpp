@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <vector>
+#include "gfx/vertex.hpp"
+#include "voxel/neighbourhood.hpp"
+
+struct ChunkMesh
+{
+    ChunkPos pos;
+    // Bumped every time the chunk is remeshed, renderer uses it to spot stale GPU copies
+    uint32_t revision{0};
+    std::vector<PackedVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    [[nodiscard]] bool empty() const
+    {
+        return indices.empty();
+    }
+};
+
+// Names a chunk's mesh for as long as the chunk stays meshed, then gets reused
+using MeshHandle = uint32_t;
+
+struct MeshStats
+{
+    // Visible block faces, what the mesh would be made of without merging
+    uint32_t faces{0};
+    uint32_t quads{0};
+    uint32_t vertices{0};
+    // Copying the neighbourhood, when the mesher made it itself
+    double copy_milliseconds{0.0};
+    double cull_milliseconds{0.0};
+    double milliseconds{0.0};
+};
+
+// Turns chunk blocks into quads in two passes:
+// - Culling works on occupancy bitmasks, one bit per block along y, in 64 bit words per column.
+//   Visible faces of a whole column come out of a single shift-and-AND (for +-y) or an AND-NOT
+//   with the neighbouring column (for +-x, +-z), no block is ever asked about its neighbours.
+// - Remaining coplanar faces of the same block and light are merged into as few rectangles as possible (greedy meshing).
+//   A face is lit by the block in front of it, that light is baked into its vertices.
+// - Every face corner gets ambient occlusion from the three blocks around it in front of the face. It comes from
+//   shifted words of the padded occupancy as well, 64 blocks at a time. Faces only merge along directions their
+//   occlusion doesn't change in.
+// Everything is read from a ChunkNeighbourhood, the mesher never looks into a chunk itself.
+// The mesher keeps its scratch memory between calls, the output mesh reuses its own buffers.
+class ChunkMesher
+{
+public:
+    ChunkMesher();
+
+    MeshStats mesh(ChunkMap const& chunks, Chunk const& chunk, ChunkMesh& out);
+    // Doesn't touch the map, for jobs running while the map itself changes. Copies the chunks into the mesher's
+    // own neighbourhood first
+    MeshStats mesh(Chunk const& chunk, ChunkNeighbourhood::Neighbours const& neighbours, ChunkMesh& out);
+    MeshStats mesh(ChunkNeighbourhood const& area, ChunkMesh& out);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int COLUMN_WORDS {ChunkNeighbourhood::COLUMN_WORDS};
+
+    void cull(ChunkNeighbourhood const& area);
+    // Occlusion of the four face corners of every block in a column word, as a low and a high bit plane per corner
+    struct Occlusion
+    {
+        std::array<uint64_t, 4> low;
+        std::array<uint64_t, 4> high;
+        // Nothing around at all, the common case
+        uint64_t open;
+    };
+
+    [[nodiscard]] static Occlusion occlusion(ChunkNeighbourhood const& area, int const x, int const z, int const word, Face const face);
+    void mesh_face(ChunkNeighbourhood const& area, Face const face, ChunkMesh& out, MeshStats& stats);
+    void merge_slice(Face const face, int const slice, ChunkMesh& out, MeshStats& stats);
+    void emit_quad(Face const face, std::array<int, 3> const& base, int const width, int const height, uint32_t const cell, ChunkMesh& out);
+
+    ChunkNeighbourhood neighbourhood_;
+    // Visible faces per direction, same column layout as occupancy, without the apron
+    std::array<std::vector<uint64_t>, static_cast<size_t>(Face::MAX_COUNT)> visible_;
+    // Block and light of visible faces for one direction, [slice][v][u], NO_FACE everywhere else
+    std::vector<uint32_t> faces_;
+};
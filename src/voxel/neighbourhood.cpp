@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstring>
+#include "voxel/neighbourhood.hpp"
+
+namespace
+{
+
+// Chunk offsets in Neighbours order
+constexpr std::array<std::array<int, 2>, 8> OFFSETS {{
+    {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1},
+}};
+
+// Blocks of a neighbour dx chunks away that end up in the apron, along one axis
+constexpr std::array<int, 2> copied_range(int const dx)
+{
+    if (dx > 0) return {0, 1};
+    if (dx < 0) return {SECTION_SIZE - 1, SECTION_SIZE};
+    return {0, SECTION_SIZE};
+}
+
+} // namespace
+
+ChunkNeighbourhood::ChunkNeighbourhood() :
+    occupancy_(PADDED * PADDED * COLUMN_WORDS),
+    blocks_(PADDED * PADDED * CHUNK_HEIGHT, static_cast<uint8_t>(Block::Air)),
+    light_(PADDED * PADDED * CHUNK_HEIGHT, FULL_SKY_LIGHT)
+{}
+
+ChunkNeighbourhood::Neighbours ChunkNeighbourhood::neighbours(ChunkMap const& chunks, ChunkPos const pos)
+{
+    Neighbours result{};
+    for (size_t idx{}; idx < OFFSETS.size(); ++idx)
+    {
+        result[idx] = chunks.get(ChunkPos{pos.x + OFFSETS[idx][0], pos.z + OFFSETS[idx][1]});
+    }
+    return result;
+}
+
+void ChunkNeighbourhood::copy(Chunk const& chunk, Neighbours const& neighbours)
+{
+    pos_ = chunk.pos();
+    std::fill(occupancy_.begin(), occupancy_.end(), 0);
+
+    // Block light reaches at most 14 blocks above the highest emitter
+    int sections{0};
+    auto const fit = [&](Chunk const* source) {
+        if (source == nullptr) return;
+        for (auto idx{sections}; idx < SECTIONS_PER_CHUNK; ++idx)
+        {
+            if (not source->section(static_cast<size_t>(idx)).empty()) sections = idx + 1;
+        }
+    };
+    fit(&chunk);
+    for (auto const* neighbour : neighbours) fit(neighbour);
+    height_ = std::min(sections + 1, SECTIONS_PER_CHUNK) * SECTION_SIZE;
+
+    copy_from(&chunk, 0, 0);
+    for (size_t idx{}; idx < OFFSETS.size(); ++idx)
+    {
+        copy_from(neighbours[idx], OFFSETS[idx][0], OFFSETS[idx][1]);
+    }
+}
+
+void ChunkNeighbourhood::copy_from(Chunk const* source, int const dx, int const dz)
+{
+    auto const [from_x, to_x] = copied_range(dx);
+    auto const [from_z, to_z] = copied_range(dz);
+    auto const width = static_cast<size_t>(to_x - from_x);
+    // Where source block 0 0 lands
+    auto const shift_x = dx * SECTION_SIZE;
+    auto const shift_z = dz * SECTION_SIZE;
+
+    if (source == nullptr)
+    {
+        for (int y{}; y < height_; ++y)
+        {
+            for (int z{from_z}; z < to_z; ++z)
+            {
+                auto const row = index(from_x + shift_x, y, z + shift_z);
+                std::fill_n(blocks_.begin() + static_cast<ptrdiff_t>(row), width, static_cast<uint8_t>(Block::Air));
+                std::fill_n(light_.begin() + static_cast<ptrdiff_t>(row), width, FULL_SKY_LIGHT);
+            }
+        }
+        return;
+    }
+
+    for (size_t idx{}; idx < static_cast<size_t>(height_ / SECTION_SIZE); ++idx)
+    {
+        auto const& section = source->section(idx);
+        auto const base = static_cast<int>(idx) * SECTION_SIZE;
+
+        // Most sections are all air or all stone, those are a fill per row
+        if (section.uniform())
+        {
+            auto const block = section.palette()[0];
+            for (int y{}; y < SECTION_SIZE; ++y)
+            {
+                for (int z{from_z}; z < to_z; ++z)
+                {
+                    std::fill_n(blocks_.begin() + static_cast<ptrdiff_t>(index(from_x + shift_x, base + y, z + shift_z)), width, static_cast<uint8_t>(block));
+                }
+            }
+            if (not is_opaque(block)) continue;
+            for (int z{from_z}; z < to_z; ++z)
+            {
+                for (int x{from_x}; x < to_x; ++x)
+                {
+                    occupancy_[column(x + shift_x, z + shift_z) + static_cast<size_t>(base / 64)] |= uint64_t{0xFFFF} << (base % 64);
+                }
+            }
+            continue;
+        }
+
+        // Opacity gathers per column first, one write per column instead of one per block
+        std::array<uint16_t, SECTION_SIZE * SECTION_SIZE> opaque{};
+        for (int y{}; y < SECTION_SIZE; ++y)
+        {
+            for (int z{from_z}; z < to_z; ++z)
+            {
+                std::array<Block, SECTION_SIZE> row;
+                section.copy_row(y, z, from_x, to_x, row.data());
+                auto* out = blocks_.data() + index(from_x + shift_x, base + y, z + shift_z);
+                for (int x{from_x}; x < to_x; ++x)
+                {
+                    auto const block = row[static_cast<size_t>(x - from_x)];
+                    out[x - from_x] = static_cast<uint8_t>(block);
+                    opaque[static_cast<size_t>(z * SECTION_SIZE + x)] |= static_cast<uint16_t>(is_opaque(block) << y);
+                }
+            }
+        }
+        for (int z{from_z}; z < to_z; ++z)
+        {
+            for (int x{from_x}; x < to_x; ++x)
+            {
+                auto const bits = uint64_t{opaque[static_cast<size_t>(z * SECTION_SIZE + x)]};
+                occupancy_[column(x + shift_x, z + shift_z) + static_cast<size_t>(base / 64)] |= bits << (base % 64);
+            }
+        }
+    }
+
+    // Light rows are contiguous in x on both sides
+    auto const light = source->light_data();
+    for (int y{}; y < height_; ++y)
+    {
+        for (int z{from_z}; z < to_z; ++z)
+        {
+            auto* row = light_.data() + index(from_x + shift_x, y, z + shift_z);
+            if (light.empty()) std::fill_n(row, width, FULL_SKY_LIGHT);
+            else if (width == SECTION_SIZE) std::memcpy(row, light.data() + Chunk::light_index(0, y, z), SECTION_SIZE);
+            else *row = light[Chunk::light_index(from_x, y, z)];
+        }
+    }
+}
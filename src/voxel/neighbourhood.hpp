@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <span>
+#include <vector>
+#include "voxel/chunk_map.hpp"
+
+// A chunk plus a one block apron from the chunks around it, blocks, light and opacity copied into padded arrays.
+// Whoever reads it never has to work out which chunk a block belongs to, and doesn't care what happens to the
+// chunks afterwards. Chunks span the whole world height, so of the 26 neighbours a cube would have only the 8
+// horizontal ones exist. Above the world reads as air in open sky, below it as air in darkness.
+// Only the height that has blocks in any of the chunks is copied, plus a section for the light of emitters
+// right at the top. Everything above is air in open sky anyway.
+// Copying reads the chunks, nothing may write them meanwhile.
+class ChunkNeighbourhood
+{
+public:
+    static constexpr int PADDED {SECTION_SIZE + 2};
+    static constexpr int COLUMN_WORDS {CHUNK_HEIGHT / 64};
+    static_assert(CHUNK_HEIGHT % 64 == 0);
+    static_assert(static_cast<size_t>(Block::MAX_COUNT) <= 256);
+
+    // Horizontal neighbours in +x, -x, +z, -z order, then the diagonal ones in +x+z, -x+z, +x-z, -x-z order.
+    // nullptr where nothing is loaded, read as air in open sky
+    using Neighbours = std::array<Chunk const*, 8>;
+
+    ChunkNeighbourhood();
+
+    [[nodiscard]] static Neighbours neighbours(ChunkMap const& chunks, ChunkPos const pos);
+
+    // All of the middle chunk, the facing side or corner column of the others. Copied a row at a time, decoded
+    // through copy_row() or, for sections of a single block, filled
+    void copy(Chunk const& chunk, Neighbours const& neighbours);
+
+    [[nodiscard]] ChunkPos pos() const
+    {
+        return pos_;
+    }
+
+    // x and z from -1 to SECTION_SIZE, y anywhere
+    [[nodiscard]] Block block(int const x, int const y, int const z) const
+    {
+        if (y < 0 or y >= height_) return Block::Air;
+        return static_cast<Block>(blocks_[index(x, y, z)]);
+    }
+
+    [[nodiscard]] uint8_t light(int const x, int const y, int const z) const
+    {
+        if (y >= height_) return FULL_SKY_LIGHT;
+        if (y < 0) return 0;
+        return light_[index(x, y, z)];
+    }
+
+    // Opaque blocks of the column at x z, one bit per block along y in COLUMN_WORDS words
+    [[nodiscard]] uint64_t const* opaque(int const x, int const z) const
+    {
+        return occupancy_.data() + column(x, z);
+    }
+
+    // Rows of columns are contiguous in x
+    [[nodiscard]] static size_t column(int const x, int const z)
+    {
+        assert(x >= -1 and x <= SECTION_SIZE and z >= -1 and z <= SECTION_SIZE);
+        return static_cast<size_t>((z + 1) * PADDED + (x + 1)) * COLUMN_WORDS;
+    }
+
+private:
+    // Layers of rows, x fastest, so rows of the middle chunk copy in one go
+    [[nodiscard]] static size_t index(int const x, int const y, int const z)
+    {
+        assert(x >= -1 and x <= SECTION_SIZE and y >= 0 and y < CHUNK_HEIGHT and z >= -1 and z <= SECTION_SIZE);
+        return (static_cast<size_t>(y) * PADDED + static_cast<size_t>(z + 1)) * PADDED + static_cast<size_t>(x + 1);
+    }
+
+    // Copies the part of source that ends up in the neighbourhood, source sits dx dz chunks from the middle
+    void copy_from(Chunk const* source, int const dx, int const dz);
+
+    ChunkPos pos_{};
+    // Copied layers, multiple of SECTION_SIZE
+    int height_{0};
+    std::vector<uint64_t> occupancy_;
+    // A byte per block is plenty and halves what gets copied
+    std::vector<uint8_t> blocks_;
+    std::vector<uint8_t> light_;
+};
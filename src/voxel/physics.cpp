@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "voxel/physics.hpp"
+
+namespace
+{
+
+// Boxes this close count as touching, not overlapping, so bodies slide along walls and floors they rest against
+constexpr float TOUCH {1e-4f};
+// Vertical first, a body landing on a floor then slides over it instead of catching on its edges
+constexpr std::array<int, 3> SWEEP_ORDER {1, 0, 2};
+
+} // namespace
+
+Physics::Physics(ChunkMap const& chunks, PhysicsSettings const& settings, std::function<bool(ChunkPos)> usable) :
+    chunks_{chunks},
+    settings_{settings},
+    usable_{std::move(usable)}
+{}
+
+void Physics::step(std::span<Body> bodies, float const dt)
+{
+    // Every body's candidates in one pass, before anything moves
+    candidates_.clear();
+    ranges_.assign(1, 0);
+    held_.assign(bodies.size(), false);
+    for (size_t idx{}; idx < bodies.size(); ++idx)
+    {
+        auto& body = bodies[idx];
+        body.velocity.y = std::max(body.velocity.y - settings_.gravity * dt, -settings_.terminal_velocity);
+
+        auto const motion = body.velocity * dt;
+        auto const half_width = body.size.x / 2.f;
+        Box reach {
+            body.position - glm::vec3{half_width, 0.f, half_width},
+            body.position + glm::vec3{half_width, body.size.y, half_width},
+        };
+        for (int axis{}; axis < 3; ++axis)
+        {
+            if (motion[axis] < 0.f) reach.min[axis] += motion[axis];
+            else reach.max[axis] += motion[axis];
+        }
+        reach.max.y += settings_.step_height;
+        held_[idx] = not gather(reach);
+        ranges_.push_back(static_cast<uint32_t>(candidates_.size()));
+    }
+
+    for (size_t idx{}; idx < bodies.size(); ++idx)
+    {
+        auto& body = bodies[idx];
+        if (held_[idx])
+        {
+            body.velocity = glm::vec3{0.f};
+            continue;
+        }
+        std::span<glm::ivec3 const> const candidates {candidates_.data() + ranges_[idx], candidates_.data() + ranges_[idx + 1]};
+
+        auto const motion = body.velocity * dt;
+        auto const half_width = body.size.x / 2.f;
+        Box const start {
+            body.position - glm::vec3{half_width, 0.f, half_width},
+            body.position + glm::vec3{half_width, body.size.y, half_width},
+        };
+        auto box = start;
+        auto moved = sweep(box, motion, candidates);
+
+        // Walked into something while standing: try again from step_height up and come back down on the other side
+        auto const blocked = moved.x != motion.x or moved.z != motion.z;
+        if (blocked and body.on_ground and settings_.step_height > 0.f)
+        {
+            auto stepped = start;
+            auto const up = sweep(stepped, {0.f, settings_.step_height, 0.f}, candidates).y;
+            auto across = sweep(stepped, {motion.x, 0.f, motion.z}, candidates);
+            auto const down = sweep(stepped, {0.f, std::min(motion.y, 0.f) - up, 0.f}, candidates).y;
+            if (across.x * across.x + across.z * across.z > moved.x * moved.x + moved.z * moved.z)
+            {
+                box = stepped;
+                moved = {across.x, up + down, across.z};
+            }
+        }
+
+        body.on_ground = motion.y < 0.f and moved.y > motion.y;
+        for (int axis{}; axis < 3; ++axis)
+        {
+            if (moved[axis] != motion[axis]) body.velocity[axis] = 0.f;
+        }
+        body.position = {(box.min.x + box.max.x) / 2.f, box.min.y, (box.min.z + box.max.z) / 2.f};
+    }
+}
+
+bool Physics::gather(Box const& box)
+{
+    glm::ivec3 const from {glm::floor(box.min - TOUCH)};
+    glm::ivec3 const to {glm::floor(box.max + TOUCH)};
+
+    for (auto chunk_z{from.z >> 4}; chunk_z <= to.z >> 4; ++chunk_z)
+    {
+        for (auto chunk_x{from.x >> 4}; chunk_x <= to.x >> 4; ++chunk_x)
+        {
+            ChunkPos const pos {chunk_x, chunk_z};
+            auto const* chunk = chunks_.get(pos);
+            if (chunk == nullptr or (usable_ and not usable_(pos))) return false;
+
+            // The part of the box inside this chunk
+            auto const x0 = std::max(from.x, chunk_x * SECTION_SIZE), x1 = std::min(to.x, chunk_x * SECTION_SIZE + SECTION_SIZE - 1);
+            auto const z0 = std::max(from.z, chunk_z * SECTION_SIZE), z1 = std::min(to.z, chunk_z * SECTION_SIZE + SECTION_SIZE - 1);
+            // Nothing to bump into above the world, the bottom of the world is solid
+            auto const y0 = std::max(from.y, -1), y1 = std::min(to.y, CHUNK_HEIGHT - 1);
+            for (int y{y0}; y <= y1; ++y)
+            {
+                if (y >= 0 and chunk->section(static_cast<size_t>(y / SECTION_SIZE)).empty())
+                {
+                    y |= SECTION_SIZE - 1;
+                    continue;
+                }
+                for (int z{z0}; z <= z1; ++z)
+                {
+                    for (int x{x0}; x <= x1; ++x)
+                    {
+                        if (y < 0 or is_opaque(chunk->get(x & (SECTION_SIZE - 1), y, z & (SECTION_SIZE - 1)))) candidates_.push_back({x, y, z});
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+glm::vec3 Physics::sweep(Box& box, glm::vec3 const& motion, std::span<glm::ivec3 const> candidates) const
+{
+    glm::vec3 moved{0.f};
+    for (auto const axis : SWEEP_ORDER)
+    {
+        if (motion[axis] == 0.f) continue;
+        moved[axis] = clip(box, axis, motion[axis], candidates);
+        box.min[axis] += moved[axis];
+        box.max[axis] += moved[axis];
+    }
+    return moved;
+}
+
+float Physics::clip(Box const& box, int const axis, float distance, std::span<glm::ivec3 const> candidates) const
+{
+    auto const first = (axis + 1) % 3;
+    auto const second = (axis + 2) % 3;
+    for (auto const& block : candidates)
+    {
+        glm::vec3 const low {block};
+        glm::vec3 const high {low + 1.f};
+        auto const overlaps = box.min[first] < high[first] - TOUCH and box.max[first] > low[first] + TOUCH
+            and box.min[second] < high[second] - TOUCH and box.max[second] > low[second] + TOUCH;
+        if (not overlaps) continue;
+
+        if (distance > 0.f and box.max[axis] <= low[axis] + TOUCH)
+        {
+            distance = std::min(distance, std::max(low[axis] - box.max[axis], 0.f));
+        }
+        else if (distance < 0.f and box.min[axis] >= high[axis] - TOUCH)
+        {
+            distance = std::max(distance, std::min(high[axis] - box.min[axis], 0.f));
+        }
+    }
+    return distance;
+}
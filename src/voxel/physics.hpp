@@ -0,0 +1,65 @@
+#pragma once
+#include <functional>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include "voxel/chunk_map.hpp"
+
+// An axis aligned box moving through the world, e.g. the player
+struct Body
+{
+    // Middle of the bottom face
+    glm::vec3 position{0.f};
+    // Blocks per second
+    glm::vec3 velocity{0.f};
+    // Width along x and z, height
+    glm::vec2 size{0.6f, 1.8f};
+    // Standing on something since the last step
+    bool on_ground{false};
+};
+
+struct PhysicsSettings
+{
+    // Blocks per second squared
+    float gravity{28.f};
+    float terminal_velocity{60.f};
+    // Bodies on the ground walk onto ledges up to this high without jumping
+    float step_height{1.f};
+};
+
+// Moves bodies through the blocks of a chunk map, sweeping their boxes one axis at a time (y first, then x and z)
+// and cutting each move short at the first opaque block in the way. Velocity along a blocked axis drops to zero.
+// A step first gathers the blocks every body could touch during it in one pass over the chunks, the sweeps then
+// only look at those.
+// Bodies next to chunks that aren't loaded, or that usable rejects, hold still until the chunks are there.
+class Physics
+{
+public:
+    // usable, when given, leaves out loaded chunks that mustn't be read yet, e.g. ones still being generated
+    explicit Physics(ChunkMap const& chunks, PhysicsSettings const& settings = {}, std::function<bool(ChunkPos)> usable = {});
+
+    // Applies gravity and moves the bodies by their velocity over dt seconds
+    void step(std::span<Body> bodies, float const dt);
+
+private:
+    struct Box
+    {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    // Opaque blocks inside the box go to candidates_, false if it reaches into a chunk that can't be read
+    [[nodiscard]] bool gather(Box const& box);
+    // Returns how far the box actually moved
+    [[nodiscard]] glm::vec3 sweep(Box& box, glm::vec3 const& motion, std::span<glm::ivec3 const> candidates) const;
+    [[nodiscard]] float clip(Box const& box, int const axis, float const distance, std::span<glm::ivec3 const> candidates) const;
+
+    ChunkMap const& chunks_;
+    PhysicsSettings settings_;
+    std::function<bool(ChunkPos)> usable_;
+    // Blocks each body may touch this step, those of body idx from ranges_[idx] to ranges_[idx + 1]
+    std::vector<glm::ivec3> candidates_;
+    std::vector<uint32_t> ranges_;
+    // Bodies which can't move this step
+    std::vector<bool> held_;
+};
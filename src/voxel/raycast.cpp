@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "voxel/raycast.hpp"
+
+namespace
+{
+
+constexpr float NEVER {std::numeric_limits<float>::infinity()};
+// Stands in for no bound along y, far enough that no ray gets there
+constexpr int FAR {1 << 24};
+
+// Blocks min to max, inclusive, known to hold nothing opaque
+struct EmptyBox
+{
+    glm::ivec3 min;
+    glm::ivec3 max;
+};
+
+} // namespace
+
+Raycaster::Raycaster(ChunkMap const& chunks, std::function<bool(ChunkPos)> usable) :
+    chunks_{chunks},
+    usable_{std::move(usable)}
+{}
+
+std::optional<RayHit> Raycaster::cast(Ray const& ray)
+{
+    cache_.fill({});
+    return trace(ray);
+}
+
+void Raycaster::cast(std::span<Ray const> rays, std::span<std::optional<RayHit>> hits)
+{
+    assert(rays.size() == hits.size());
+    cache_.fill({});
+    for (size_t idx{}; idx < rays.size(); ++idx)
+    {
+        hits[idx] = trace(rays[idx]);
+    }
+}
+
+Chunk const* Raycaster::chunk(ChunkPos const pos)
+{
+    auto& cached = cache_[static_cast<size_t>((pos.x & 7) | ((pos.z & 7) << 3))];
+    if (not cached.valid or cached.pos != pos)
+    {
+        auto const* found = usable_ and not usable_(pos) ? nullptr : chunks_.get(pos);
+        cached = {pos, found, true};
+    }
+    return cached.chunk;
+}
+
+std::optional<RayHit> Raycaster::trace(Ray const& ray)
+{
+    auto const length = glm::length(ray.direction);
+    assert(length > 0.f);
+    auto const direction = ray.direction / length;
+    auto const& origin = ray.origin;
+
+    glm::ivec3 cell {glm::floor(origin)};
+    glm::ivec3 step{};
+    glm::vec3 t_delta{NEVER};
+    glm::vec3 t_max{NEVER};
+    // Distance to where the ray crosses the next grid line on each axis
+    auto const crossings = [&] {
+        for (int axis{}; axis < 3; ++axis)
+        {
+            if (step[axis] > 0) t_max[axis] = (static_cast<float>(cell[axis] + 1) - origin[axis]) / direction[axis];
+            else if (step[axis] < 0) t_max[axis] = (static_cast<float>(cell[axis]) - origin[axis]) / direction[axis];
+        }
+    };
+    for (int axis{}; axis < 3; ++axis)
+    {
+        if (direction[axis] == 0.f) continue;
+        step[axis] = direction[axis] > 0.f ? 1 : -1;
+        t_delta[axis] = std::abs(1.f / direction[axis]);
+    }
+    crossings();
+
+    // Starting inside a block counts as coming in against the main direction
+    auto const magnitude = glm::abs(direction);
+    int entered {magnitude.x >= magnitude.y ? (magnitude.x >= magnitude.z ? 0 : 2) : (magnitude.y >= magnitude.z ? 1 : 2)};
+    float distance {0.f};
+
+    ChunkPos pos {cell.x >> 4, cell.z >> 4};
+    auto const* current = chunk(pos);
+    auto skip_chunk = current == nullptr or current->empty();
+    while (distance <= ray.max_distance)
+    {
+        // Nothing comes back into the world once it left it upwards or downwards
+        if ((cell.y >= CHUNK_HEIGHT and step.y >= 0) or (cell.y < 0 and step.y <= 0)) return std::nullopt;
+
+        ChunkPos const cell_pos {cell.x >> 4, cell.z >> 4};
+        if (cell_pos != pos)
+        {
+            pos = cell_pos;
+            current = chunk(pos);
+            skip_chunk = current == nullptr or current->empty();
+        }
+
+        std::optional<EmptyBox> empty;
+        glm::ivec3 const corner {pos.x * SECTION_SIZE, 0, pos.z * SECTION_SIZE};
+        glm::ivec3 const column_end {corner.x + SECTION_SIZE - 1, 0, corner.z + SECTION_SIZE - 1};
+        if (skip_chunk)
+        {
+            empty = EmptyBox{{corner.x, -FAR, corner.z}, {column_end.x, FAR, column_end.z}};
+        }
+        else if (cell.y >= CHUNK_HEIGHT)
+        {
+            empty = EmptyBox{{corner.x, CHUNK_HEIGHT, corner.z}, {column_end.x, FAR, column_end.z}};
+        }
+        else if (cell.y < 0)
+        {
+            empty = EmptyBox{{corner.x, -FAR, corner.z}, {column_end.x, -1, column_end.z}};
+        }
+        else
+        {
+            auto const& section = current->section(static_cast<size_t>(cell.y / SECTION_SIZE));
+            if (section.empty())
+            {
+                auto const bottom = cell.y & ~(SECTION_SIZE - 1);
+                empty = EmptyBox{{corner.x, bottom, corner.z}, {column_end.x, bottom + SECTION_SIZE - 1, column_end.z}};
+            }
+            else
+            {
+                auto const block = section.get(cell.x & (SECTION_SIZE - 1), cell.y & (SECTION_SIZE - 1), cell.z & (SECTION_SIZE - 1));
+                if (is_opaque(block))
+                {
+                    auto const face = static_cast<Face>(entered * 2 + (step[entered] > 0 ? 1 : 0));
+                    return RayHit{cell, block, face, distance};
+                }
+            }
+        }
+
+        if (not empty)
+        {
+            // One block further along whichever grid line comes first
+            auto const axis = t_max.x < t_max.y ? (t_max.x < t_max.z ? 0 : 2) : (t_max.y < t_max.z ? 1 : 2);
+            distance = t_max[axis];
+            cell[axis] += step[axis];
+            t_max[axis] += t_delta[axis];
+            entered = axis;
+            continue;
+        }
+
+        // Straight to the first block past the box, then pick up the walk from there
+        glm::vec3 exit{NEVER};
+        for (int axis{}; axis < 3; ++axis)
+        {
+            if (step[axis] > 0) exit[axis] = (static_cast<float>(empty->max[axis] + 1) - origin[axis]) / direction[axis];
+            else if (step[axis] < 0) exit[axis] = (static_cast<float>(empty->min[axis]) - origin[axis]) / direction[axis];
+        }
+        auto const axis = exit.x < exit.y ? (exit.x < exit.z ? 0 : 2) : (exit.y < exit.z ? 1 : 2);
+        // Never backwards, rounding may put the box exit a hair before where the ray already is
+        distance = std::max(distance, exit[axis]);
+        for (int other{}; other < 3; ++other)
+        {
+            if (other == axis) continue;
+            auto const along = static_cast<int>(std::floor(origin[other] + direction[other] * distance));
+            cell[other] = std::clamp(along, empty->min[other], empty->max[other]);
+        }
+        cell[axis] = step[axis] > 0 ? empty->max[axis] + 1 : empty->min[axis] - 1;
+        crossings();
+        entered = axis;
+    }
+    return std::nullopt;
+}
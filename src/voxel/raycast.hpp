@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <optional>
+#include <span>
+#include <glm/glm.hpp>
+#include "voxel/chunk_map.hpp"
+
+struct Ray
+{
+    glm::vec3 origin;
+    // Any length but zero
+    glm::vec3 direction;
+    // In blocks
+    float max_distance;
+};
+
+struct RayHit
+{
+    glm::ivec3 position;
+    Block block;
+    // The face the ray came in through, the hit block is the origin's own if it starts inside one
+    Face face;
+    // Along the ray to where it enters the block, 0 when it starts inside
+    float distance;
+};
+
+// Finds the first opaque block along rays by walking the blocks they pass through in order, one grid line at a time
+// (Amanatides and Woo). Empty sections, chunks that are empty or not loaded and everything above or below the world
+// are crossed in a single step, so rays through the sky or caves cost a step per 16 blocks at most.
+// Chunk lookups are cached for the duration of a call. Nothing may load, unload or edit chunks meanwhile.
+class Raycaster
+{
+public:
+    // usable, when given, leaves out loaded chunks that mustn't be read yet, they read as not loaded
+    explicit Raycaster(ChunkMap const& chunks, std::function<bool(ChunkPos)> usable = {});
+
+    [[nodiscard]] std::optional<RayHit> cast(Ray const& ray);
+    // hits[idx] for rays[idx]. The whole batch shares the lookups, rays starting close together hardly probe the map
+    void cast(std::span<Ray const> rays, std::span<std::optional<RayHit>> hits);
+
+private:
+    // Direct mapped by the low bits of the chunk position
+    struct CachedChunk
+    {
+        ChunkPos pos{};
+        Chunk const* chunk{nullptr};
+        bool valid{false};
+    };
+
+    [[nodiscard]] std::optional<RayHit> trace(Ray const& ray);
+    [[nodiscard]] Chunk const* chunk(ChunkPos const pos);
+
+    ChunkMap const& chunks_;
+    std::function<bool(ChunkPos)> usable_;
+    std::array<CachedChunk, 64> cache_{};
+};
@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <cmath>
+#include "voxel/streamer.hpp"
+#include "profiler.hpp"
+
+namespace
+{
+
+ChunkPos chunk_at(glm::vec3 const& position)
+{
+    return {
+        static_cast<int32_t>(std::floor(position.x / SECTION_SIZE)),
+        static_cast<int32_t>(std::floor(position.z / SECTION_SIZE)),
+    };
+}
+
+ChunkPos chunk_at(glm::ivec3 const& block)
+{
+    return {block.x >> 4, block.z >> 4};
+}
+
+int distance_squared(ChunkPos const a, ChunkPos const b)
+{
+    auto const dx = a.x - b.x;
+    auto const dz = a.z - b.z;
+    return dx * dx + dz * dz;
+}
+
+} // namespace
+
+ChunkStreamer::ChunkStreamer(JobSystem& jobs, ChunkMap& chunks, TerrainGenerator const& terrain, ChunkWriter* writer, StreamingSettings const& settings) :
+    jobs_{jobs},
+    chunks_{chunks},
+    terrain_{terrain},
+    writer_{writer},
+    settings_{settings},
+    meshers_(jobs.thread_count()),
+    lighters_(jobs.thread_count())
+{
+    // Meshes need all eight chunks around, so the outer ring also covers the diagonals of the mesh radius
+    auto const radius_squared = settings_.radius * settings_.radius;
+    auto const generated = settings_.radius + 1;
+    for (int dz{-generated}; dz <= generated; ++dz)
+    {
+        for (int dx{-generated}; dx <= generated; ++dx)
+        {
+            auto const nearest_x = std::max(std::abs(dx) - 1, 0);
+            auto const nearest_z = std::max(std::abs(dz) - 1, 0);
+            if (nearest_x * nearest_x + nearest_z * nearest_z > radius_squared) continue;
+            offsets_.push_back({dx, dz, dx * dx + dz * dz <= radius_squared});
+        }
+    }
+    std::stable_sort(offsets_.begin(), offsets_.end(), [](Offset const& a, Offset const& b) {
+        return a.dx * a.dx + a.dz * a.dz < b.dx * b.dx + b.dz * b.dz;
+    });
+}
+
+ChunkStreamer::~ChunkStreamer()
+{
+    // Jobs hold pointers into the map and to this streamer
+    jobs_.wait(jobs_in_flight_);
+}
+
+void ChunkStreamer::finish_jobs()
+{
+    jobs_.wait(jobs_in_flight_);
+}
+
+void ChunkStreamer::update(glm::vec3 const& player_position)
+{
+    PROFILE_SCOPE("streaming");
+    collect();
+    apply_edits();
+    remesh_touched();
+
+    auto const center = chunk_at(player_position);
+    if (center != center_)
+    {
+        center_ = center;
+        evict_pending_ = true;
+    }
+    if (evict_pending_) evict();
+
+    submit();
+
+    stats_.loaded = static_cast<uint32_t>(chunks_.size());
+    stats_.meshed = static_cast<uint32_t>(meshes_.size() - free_meshes_.size());
+    auto const now = Clock::now();
+    auto const elapsed = std::chrono::duration<double>(now - rate_start_).count();
+    if (elapsed >= 1.0)
+    {
+        stats_.loaded_per_second = loaded_since_rate_start_ / elapsed;
+        loaded_since_rate_start_ = 0;
+        rate_start_ = now;
+    }
+}
+
+void ChunkStreamer::collect()
+{
+    auto const finished = std::partition(in_flight_.begin(), in_flight_.end(), [](auto const& task) {
+        return not task->done.load(std::memory_order_acquire);
+    });
+
+    for (auto it = finished; it != in_flight_.end(); ++it)
+    {
+        auto& task = **it;
+        auto& chunk_entry = *entry(task.chunk->pos());
+        if (settings_.time_jobs)
+        {
+            auto& times = task.work == Work::Generate ? job_times_.generate : task.work == Work::Stitch ? job_times_.stitch : job_times_.mesh;
+            times.push_back(task.milliseconds);
+        }
+        if (task.work == Work::Generate)
+        {
+            pin(*task.chunk, -1);
+            chunk_entry.state = State::Generated;
+            unlit_.push_back(task.chunk->pos());
+            ++loaded_since_rate_start_;
+            --stats_.generating;
+            continue;
+        }
+        if (task.work == Work::Stitch)
+        {
+            for (auto const* chunk : task.area)
+            {
+                if (chunk == nullptr) continue;
+                pin(*chunk, -1);
+                entry(chunk->pos())->lighting = false;
+            }
+            chunk_entry.state = State::Lit;
+            for (auto const pos : task.touched)
+            {
+                remesh(pos);
+            }
+            --stats_.stitching;
+            continue;
+        }
+
+        pin(*task.chunk, -1);
+        for (auto const* neighbour : task.neighbours)
+        {
+            pin(*neighbour, -1);
+        }
+        chunk_entry.state = State::Meshed;
+        if (chunk_entry.mesh == NO_MESH)
+        {
+            if (free_meshes_.empty())
+            {
+                chunk_entry.mesh = static_cast<MeshHandle>(meshes_.size());
+                meshes_.emplace_back();
+            }
+            else
+            {
+                chunk_entry.mesh = free_meshes_.back();
+                free_meshes_.pop_back();
+            }
+        }
+        meshes_[chunk_entry.mesh] = std::move(task.mesh);
+        mesh_changes_.push_back(chunk_entry.mesh);
+        --stats_.meshing;
+    }
+    in_flight_.erase(finished, in_flight_.end());
+}
+
+void ChunkStreamer::edit(glm::ivec3 const& position, Block const block)
+{
+    if (position.y < 0 or position.y >= CHUNK_HEIGHT) return;
+    edits_.push_back({position, block});
+}
+
+void ChunkStreamer::apply_edits()
+{
+    auto const kept = std::remove_if(edits_.begin(), edits_.end(), [&](Edit const& edit) {
+        auto const pos = chunk_at(edit.position);
+        if (entry(pos) == nullptr) return true;
+        // Jobs may be reading chunks the light reaches, try again next update
+        if (not area_idle(pos)) return false;
+
+        auto const x = edit.position.x - pos.x * SECTION_SIZE;
+        auto const z = edit.position.z - pos.z * SECTION_SIZE;
+        auto& chunk = *chunks_.get(pos);
+        if (chunk.get(x, edit.position.y, z) == edit.block) return true;
+        chunk.set(x, edit.position.y, z, edit.block);
+        light_.block_changed(LightEngine::area(chunks_, pos), x, edit.position.y, z);
+        if (writer_ != nullptr) writer_->mark_dirty(pos);
+
+        // Faces on the border belong to the neighbour's mesh as well
+        remesh(pos);
+        if (x == 0) remesh({pos.x - 1, pos.z});
+        if (x == SECTION_SIZE - 1) remesh({pos.x + 1, pos.z});
+        if (z == 0) remesh({pos.x, pos.z - 1});
+        if (z == SECTION_SIZE - 1) remesh({pos.x, pos.z + 1});
+        // Corner blocks occlude faces in the diagonal chunks too
+        if ((x == 0 or x == SECTION_SIZE - 1) and (z == 0 or z == SECTION_SIZE - 1))
+        {
+            remesh({pos.x + (x == 0 ? -1 : 1), pos.z + (z == 0 ? -1 : 1)});
+        }
+        return true;
+    });
+    edits_.erase(kept, edits_.end());
+}
+
+void ChunkStreamer::remesh(ChunkPos const pos)
+{
+    // Back to lit, submit() picks it up like any other chunk waiting for a mesh
+    auto* chunk_entry = entry(pos);
+    if (chunk_entry != nullptr and chunk_entry->state == State::Meshed) chunk_entry->state = State::Lit;
+}
+
+void ChunkStreamer::remesh_touched()
+{
+    for (auto const pos : light_.touched())
+    {
+        remesh(pos);
+    }
+    light_.clear_touched();
+}
+
+bool ChunkStreamer::area_idle(ChunkPos const pos)
+{
+    for (int dz{-1}; dz <= 1; ++dz)
+    {
+        for (int dx{-1}; dx <= 1; ++dx)
+        {
+            auto const* chunk_entry = entry({pos.x + dx, pos.z + dz});
+            if (chunk_entry != nullptr and (chunk_entry->pins > 0 or chunk_entry->state == State::Generating)) return false;
+        }
+    }
+    return true;
+}
+
+void ChunkStreamer::evict()
+{
+    // The generated ring reaches up to sqrt(2) chunks past the radius
+    auto const keep = settings_.radius + 2 + settings_.unload_margin;
+    evict_scratch_.clear();
+    for (auto const* chunk : chunks_)
+    {
+        if (distance_squared(chunk->pos(), center_) > keep * keep) evict_scratch_.push_back(chunk->pos());
+    }
+
+    evict_pending_ = false;
+    for (auto const pos : evict_scratch_)
+    {
+        auto& chunk_entry = *entry(pos);
+        // Still used by a job, try again next update
+        if (chunk_entry.pins > 0)
+        {
+            evict_pending_ = true;
+            continue;
+        }
+        // Edited since the last save and the writer is backed up, keep it around until it isn't
+        if (writer_ != nullptr and not writer_->release(pos))
+        {
+            evict_pending_ = true;
+            continue;
+        }
+        remove_mesh(chunk_entry);
+        chunk_entry = {};
+        chunks_.erase(pos);
+    }
+}
+
+void ChunkStreamer::submit()
+{
+    auto budget = settings_.submit_budget;
+    auto const can_submit = [&] {
+        return budget > 0 and in_flight_.size() < settings_.max_in_flight;
+    };
+
+    // Stitching first, meshes wait for it
+    auto const kept = std::remove_if(unlit_.begin(), unlit_.end(), [&](ChunkPos const pos) {
+        // Unloaded, or unloaded and generating again, that run queues it anew
+        auto* chunk_entry = entry(pos);
+        if (chunk_entry == nullptr or chunk_entry->state != State::Generated) return true;
+        if (not can_submit() or not area_idle(pos)) return false;
+
+        start_stitching(*chunks_.get(pos));
+        --budget;
+        return true;
+    });
+    unlit_.erase(kept, unlit_.end());
+    stats_.waiting_for_light = static_cast<uint32_t>(unlit_.size());
+
+    stats_.waiting_for_generation = 0;
+    stats_.waiting_for_mesh = 0;
+    for (auto const offset : offsets_)
+    {
+        ChunkPos const pos {center_.x + offset.dx, center_.z + offset.dz};
+        auto* chunk = chunks_.get(pos);
+        if (chunk == nullptr)
+        {
+            ++stats_.waiting_for_generation;
+            if (not can_submit()) continue;
+            start_generation(pos);
+            --budget;
+            continue;
+        }
+
+        auto const& chunk_entry = *entry(pos);
+        if (not offset.mesh or chunk_entry.state != State::Lit or chunk_entry.lighting) continue;
+        auto const neighbours = ChunkNeighbourhood::neighbours(chunks_, pos);
+        // Their border light shows on this mesh
+        auto const ready = std::all_of(neighbours.begin(), neighbours.end(), [&](Chunk const* neighbour) {
+            if (neighbour == nullptr) return false;
+            auto const& neighbour_entry = *entry(neighbour->pos());
+            return neighbour_entry.state != State::Generating and neighbour_entry.state != State::Generated and not neighbour_entry.lighting;
+        });
+        if (not ready) continue;
+
+        ++stats_.waiting_for_mesh;
+        if (not can_submit()) continue;
+        start_meshing(*chunk, neighbours);
+        --budget;
+    }
+}
+
+void ChunkStreamer::start_generation(ChunkPos const pos)
+{
+    auto const handle = chunks_.emplace(pos);
+    if (handle.slot >= entries_.size()) entries_.resize(handle.slot + 1);
+    entries_[handle.slot] = {};
+
+    auto& task = *in_flight_.emplace_back(std::make_unique<Task>());
+    task.chunk = chunks_.get(handle);
+    pin(*task.chunk, 1);
+    ++stats_.generating;
+    jobs_.submit([this, &task] { run(task); }, jobs_in_flight_);
+}
+
+void ChunkStreamer::start_stitching(Chunk& chunk)
+{
+    auto& task = *in_flight_.emplace_back(std::make_unique<Task>());
+    task.work = Work::Stitch;
+    task.chunk = &chunk;
+    task.area = LightEngine::area(chunks_, chunk.pos());
+
+    // Light from the middle reaches into all of them
+    for (auto const* neighbour : task.area)
+    {
+        if (neighbour == nullptr) continue;
+        pin(*neighbour, 1);
+        entry(neighbour->pos())->lighting = true;
+    }
+    ++stats_.stitching;
+    jobs_.submit([this, &task] { run(task); }, jobs_in_flight_);
+}
+
+void ChunkStreamer::start_meshing(Chunk& chunk, ChunkNeighbourhood::Neighbours const& neighbours)
+{
+    auto& chunk_entry = *entry(chunk.pos());
+    chunk_entry.state = State::Meshing;
+
+    auto& task = *in_flight_.emplace_back(std::make_unique<Task>());
+    task.work = Work::Mesh;
+    task.chunk = &chunk;
+    task.neighbours = neighbours;
+    // Remeshing continues the revision count so the renderer notices the change
+    task.mesh = std::make_shared<ChunkMesh>();
+    if (chunk_entry.mesh != NO_MESH) task.mesh->revision = meshes_[chunk_entry.mesh]->revision;
+
+    pin(chunk, 1);
+    for (auto const* neighbour : neighbours)
+    {
+        pin(*neighbour, 1);
+    }
+    ++stats_.meshing;
+    jobs_.submit([this, &task] { run(task); }, jobs_in_flight_);
+}
+
+void ChunkStreamer::run(Task& task)
+{
+    auto const start = settings_.time_jobs ? Clock::now() : Clock::time_point{};
+    auto const thread = jobs_.thread_index();
+    switch (task.work)
+    {
+    case Work::Generate:
+    {
+        PROFILE_SCOPE("generate");
+        if (writer_ == nullptr or not writer_->load(*task.chunk)) terrain_.generate(*task.chunk);
+        lighters_[thread].light_chunk(*task.chunk);
+        break;
+    }
+    case Work::Stitch:
+    {
+        PROFILE_SCOPE("stitch");
+        auto& lighter = lighters_[thread];
+        lighter.stitch(task.area);
+        task.touched.assign(lighter.touched().begin(), lighter.touched().end());
+        lighter.clear_touched();
+        break;
+    }
+    case Work::Mesh:
+    {
+        PROFILE_SCOPE("mesh");
+        meshers_[thread].mesh(*task.chunk, task.neighbours, *task.mesh);
+        break;
+    }
+    }
+    if (settings_.time_jobs) task.milliseconds = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    task.done.store(true, std::memory_order_release);
+}
+
+void ChunkStreamer::pin(Chunk const& chunk, int const delta)
+{
+    auto& chunk_entry = *entry(chunk.pos());
+    chunk_entry.pins = static_cast<uint16_t>(chunk_entry.pins + delta);
+}
+
+void ChunkStreamer::remove_mesh(Entry& chunk_entry)
+{
+    if (chunk_entry.mesh == NO_MESH) return;
+
+    // Handles stay put, the freed one goes to the next chunk to be meshed
+    meshes_[chunk_entry.mesh].reset();
+    free_meshes_.push_back(chunk_entry.mesh);
+    mesh_changes_.push_back(chunk_entry.mesh);
+    chunk_entry.mesh = NO_MESH;
+}
+
+bool ChunkStreamer::blocks_ready(ChunkPos const pos) const
+{
+    auto const handle = chunks_.handle(pos);
+    return handle.valid() and entries_[handle.slot].state != State::Generating;
+}
+
+ChunkStreamer::Entry* ChunkStreamer::entry(ChunkPos const pos)
+{
+    auto const handle = chunks_.handle(pos);
+    return handle.valid() ? &entries_[handle.slot] : nullptr;
+}
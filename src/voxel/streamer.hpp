@@ -0,0 +1,223 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include "jobs.hpp"
+#include "persist/writer.hpp"
+#include "voxel/chunk_map.hpp"
+#include "voxel/light.hpp"
+#include "voxel/mesher.hpp"
+#include "worldgen/terrain.hpp"
+
+struct StreamingSettings
+{
+    // Chunks within this many chunks of the player get meshed, one more ring is generated for their borders and corners
+    int radius{8};
+    // Chunks are only unloaded once they are this much further out, moving back and forth over a border reloads nothing
+    int unload_margin{2};
+    // New jobs per update, bounds the main thread work of a single update no matter how far the player moved
+    uint32_t submit_budget{8};
+    // Jobs queued or running, kept short so chunks near a player who just turned around don't wait behind far ones
+    uint32_t max_in_flight{32};
+    // Measures every job, see job_times()
+    bool time_jobs{false};
+};
+
+struct StreamingStats
+{
+    // Queue depths: chunks in range which are not generated yet, generated chunks ready to be meshed
+    uint32_t waiting_for_generation{0};
+    uint32_t waiting_for_mesh{0};
+    // Generated chunks whose light isn't stitched to the neighbours yet
+    uint32_t waiting_for_light{0};
+    // Jobs in flight
+    uint32_t generating{0};
+    uint32_t stitching{0};
+    uint32_t meshing{0};
+    uint32_t loaded{0};
+    uint32_t meshed{0};
+    double loaded_per_second{0.0};
+};
+
+// Wall time of finished jobs, in milliseconds
+struct JobTimes
+{
+    std::vector<float> generate;
+    std::vector<float> stitch;
+    std::vector<float> mesh;
+};
+
+// Keeps the chunks around the player loaded and meshed, nearest first.
+// Chunks come from storage when they were saved before and from the terrain generator otherwise.
+// Generation jobs also light the chunk on its own, a stitching job then lets light flow over its borders before
+// it gets meshed. Edits are queued and applied once no job uses the chunks around, they relight what they
+// affect, remesh every chunk whose mesh shows the change and mark the chunk dirty. Dirty chunks only unload after
+// the writer took a snapshot of them.
+// Generation, stitching and meshing run as jobs and are never waited on: every update collects finished jobs,
+// unloads chunks that fell out of range and submits a bounded amount of new work.
+// The chunk map keeps changing while jobs run, so jobs never look into it. They get their chunks as
+// pointers, and every chunk a job reads or writes stays pinned (never unloaded) until the job is collected.
+class ChunkStreamer
+{
+public:
+    // writer may be null, everything is generated then and edits are lost on unload
+    ChunkStreamer(JobSystem& jobs, ChunkMap& chunks, TerrainGenerator const& terrain, ChunkWriter* writer, StreamingSettings const& settings);
+    ~ChunkStreamer();
+
+    ChunkStreamer(ChunkStreamer const&) = delete;
+    ChunkStreamer& operator=(ChunkStreamer const&) = delete;
+
+    void update(glm::vec3 const& player_position);
+    // Applied by a later update, dropped if the chunk isn't loaded by then
+    void edit(glm::ivec3 const& position, Block const block);
+
+    // Indexed by handle, null for free handles. A remesh replaces the chunk's mesh, the old one stays
+    // as it was for whoever still holds it
+    [[nodiscard]] std::span<std::shared_ptr<ChunkMesh const> const> meshes() const
+    {
+        return meshes_;
+    }
+
+    // Handles whose mesh was replaced or dropped since the last clear, possibly more than once.
+    // They pile up until the owner clears them
+    [[nodiscard]] std::span<MeshHandle const> mesh_changes() const
+    {
+        return mesh_changes_;
+    }
+
+    void clear_mesh_changes()
+    {
+        mesh_changes_.clear();
+    }
+
+    // Waits for every job in flight, the next update collects all of them. A world that does this after every
+    // update depends on nothing but its inputs, how fast jobs run no longer matters.
+    // Only the thread calling update(), which submits the jobs as thread 0 of the job system
+    void finish_jobs();
+
+    // Loaded and no job writes its blocks anymore, only then may the main thread read them
+    [[nodiscard]] bool blocks_ready(ChunkPos const pos) const;
+
+    // Every job collected so far, empty unless the settings ask for them
+    [[nodiscard]] JobTimes const& job_times() const
+    {
+        return job_times_;
+    }
+
+    [[nodiscard]] StreamingStats const& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint32_t NO_MESH {ChunkHandle::INVALID};
+
+    enum class State : uint8_t
+    {
+        Generating,
+        // Lit on its own, light from the neighbours is still missing
+        Generated,
+        Lit,
+        Meshing,
+        Meshed,
+    };
+
+    // Per loaded chunk bookkeeping, indexed by ChunkHandle::slot
+    struct Entry
+    {
+        State state{State::Generating};
+        // Jobs in flight using the chunk
+        uint16_t pins{0};
+        // A stitching job writes its light, nothing may read it meanwhile
+        bool lighting{false};
+        // Handle of its mesh
+        MeshHandle mesh{NO_MESH};
+    };
+
+    struct Offset
+    {
+        int dx;
+        int dz;
+        // Inside the radius proper, the outermost ring is only generated
+        bool mesh;
+    };
+
+    struct Edit
+    {
+        glm::ivec3 position;
+        Block block;
+    };
+
+    enum class Work : uint8_t
+    {
+        Generate,
+        Stitch,
+        Mesh,
+    };
+
+    struct Task
+    {
+        Work work{Work::Generate};
+        Chunk* chunk{nullptr};
+        ChunkNeighbourhood::Neighbours neighbours{};
+        std::shared_ptr<ChunkMesh> mesh;
+        // Stitching: the chunks around, and those whose light changed
+        LightArea area{};
+        std::vector<ChunkPos> touched;
+        float milliseconds{0.f};
+        std::atomic<bool> done{false};
+    };
+
+    void collect();
+    void apply_edits();
+    void remesh(ChunkPos const pos);
+    void remesh_touched();
+    // Nothing in the 3 x 3 chunks around pos is in use by a job, light changes in pos may reach all of them
+    [[nodiscard]] bool area_idle(ChunkPos const pos);
+    void evict();
+    void submit();
+    void start_generation(ChunkPos const pos);
+    void start_stitching(Chunk& chunk);
+    void start_meshing(Chunk& chunk, ChunkNeighbourhood::Neighbours const& neighbours);
+    void run(Task& task);
+    void pin(Chunk const& chunk, int const delta);
+    void remove_mesh(Entry& entry);
+
+    [[nodiscard]] Entry* entry(ChunkPos const pos);
+
+    JobSystem& jobs_;
+    ChunkMap& chunks_;
+    TerrainGenerator const& terrain_;
+    ChunkWriter* writer_;
+    StreamingSettings settings_;
+
+    // Nearest first, precomputed once for the whole radius
+    std::vector<Offset> offsets_;
+    std::vector<Entry> entries_;
+    std::vector<std::shared_ptr<ChunkMesh const>> meshes_;
+    std::vector<MeshHandle> free_meshes_;
+    std::vector<MeshHandle> mesh_changes_;
+    // One per job system thread
+    std::vector<ChunkMesher> meshers_;
+    std::vector<LightEngine> lighters_;
+    std::vector<std::unique_ptr<Task>> in_flight_;
+    JobCounter jobs_in_flight_{0};
+
+    ChunkPos center_{};
+    bool evict_pending_{true};
+    std::vector<ChunkPos> evict_scratch_;
+    std::vector<Edit> edits_;
+    // Generated chunks waiting for stitching, in the order they were generated
+    std::vector<ChunkPos> unlit_;
+    // Edits relight on the main thread
+    LightEngine light_;
+
+    StreamingStats stats_;
+    JobTimes job_times_;
+    Clock::time_point rate_start_{Clock::now()};
+    uint32_t loaded_since_rate_start_{0};
+};
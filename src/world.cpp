@@ -1,88 +1,187 @@
 #include "world.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include "persist/chunk_codec.hpp"
 #include <glm/gtc/constants.hpp>
 #include "log.hpp"
+#include "profiler.hpp"
 
 namespace 
 {
 
-glm::vec3 calculate_movement(Action const action, float const speed, float const yaw)
+// Blocks per second
+constexpr float WALK_SPEED {4.3f};
+// About a block and a quarter high
+constexpr float JUMP_SPEED {8.4f};
+constexpr float EYE_HEIGHT {1.62f};
+constexpr glm::vec2 PLAYER_SIZE {0.6f, 1.8f};
+
+// Horizontal velocity the held actions ask for, Up jumps when standing.
+// Adds the directions up in a fixed order, whatever order the keys were pressed in, so replays come out the same
+glm::vec3 walk_velocity(std::span<Action const> actions, float const yaw)
 {
-    float delta {speed * 0.003f};
-    glm::vec3 mov(0.0f);
-    switch (action) {
-        case Action::Backward:
-            delta *= -1.f;
-            [[fallthrough]];
-        case Action::Forward:
-            mov.z += sinf(yaw) * delta;
-            mov.x += cosf(yaw) * delta;
-            break;
-        case Action::Left:
-            delta *= -1.f;
-            [[fallthrough]];
-        case Action::Right:;
-            mov.z += sinf(yaw + glm::half_pi<float>()) * delta;
-            mov.x += cosf(yaw + glm::half_pi<float>()) * delta;
-            break;
-        case Action::Up:
-            delta *= -1.f;
-            [[fallthrough]];
-        case Action::Down:
-            mov.y += delta;
-            break;
-        default: break;
+    std::array<bool, static_cast<size_t>(Action::MAX_COUNT)> held{};
+    for (auto const action : actions)
+    {
+        held[static_cast<size_t>(action)] = true;
     }
-    return mov;
+
+    glm::vec2 direction{0.f};
+    for (size_t idx{}; idx < held.size(); ++idx)
+    {
+        if (not held[idx]) continue;
+        switch (static_cast<Action>(idx)) {
+            case Action::Forward:
+                direction += glm::vec2{cosf(yaw), sinf(yaw)};
+                break;
+            case Action::Backward:
+                direction -= glm::vec2{cosf(yaw), sinf(yaw)};
+                break;
+            case Action::Right:
+                direction += glm::vec2{cosf(yaw + glm::half_pi<float>()), sinf(yaw + glm::half_pi<float>())};
+                break;
+            case Action::Left:
+                direction -= glm::vec2{cosf(yaw + glm::half_pi<float>()), sinf(yaw + glm::half_pi<float>())};
+                break;
+            default: break;
+        }
+    }
+    if (glm::length(direction) > 0.f) direction = glm::normalize(direction) * WALK_SPEED;
+    return {direction.x, 0.f, direction.y};
 }
 
-constexpr glm::vec3 red{1.f, 0.f, 0.f};
-constexpr glm::vec3 blue{0.f, 0.f, 1.f};
-constexpr glm::vec3 green{0.f, 1.f, 0.f};
-
-constexpr glm::vec2 left_lower {0.f, 0.f};
-constexpr glm::vec2 left_upper {0.f, 1.f};
-constexpr glm::vec2 right_lower {1.f, 0.f};
-constexpr glm::vec2 right_upper {1.f, 1.f};
-
-constexpr float p {0.5f};
-const std::vector verticies {
-    Vertex{{-p, -p, -p}, red, left_lower},  // 0
-    Vertex{{-p, p, -p}, green, right_upper}, // 1
-    Vertex{{p, p, -p}, blue, left_upper},   // 2
-    Vertex{{p, -p, -p}, red, right_lower},   // 3
-    Vertex{{p, -p, p}, green, left_lower},  // 4
-    Vertex{{p, p, p}, blue, left_upper},    // 5
-    Vertex{{-p, p, p}, red, right_lower},    // 6
-    Vertex{{-p, -p, p}, green, right_upper}, // 7
-};
+constexpr uint32_t WORLD_SEED {1337};
 
-const std::vector<uint16_t> indices
+// FNV-1a, 64 bit
+struct Checksum
 {
-    0, 2, 1, 0, 3, 2, // front
-    3, 2, 4, 5, 4, 2, // right
-    1, 0, 6, 0, 7, 6, // left
-    1, 2, 6, 2, 6, 5, // up
-    0, 3, 7, 3, 7, 4, // down
-    7, 4, 5, 7, 5, 6, // back
+    uint64_t value {0xcbf29ce484222325ull};
+
+    void add(std::span<uint8_t const> bytes)
+    {
+        for (auto const byte : bytes)
+        {
+            value = (value ^ byte) * 0x100000001b3ull;
+        }
+    }
+
+    template <typename T>
+    void add(T const& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        add(std::span{reinterpret_cast<uint8_t const*>(&value), sizeof(T)});
+    }
+
+    template <typename T>
+    void add_all(std::vector<T> const& values)
+    {
+        add(std::span{reinterpret_cast<uint8_t const*>(values.data()), values.size() * sizeof(T)});
+    }
 };
 
 } // namespace
 
-World::World(glm::uvec2 const& extent, float const time_per_tick) :
+World::World(JobSystem& jobs, glm::uvec2 const& extent, float const time_per_tick, std::filesystem::path const& save_directory,
+    StreamingSettings const& streaming) :
     camera_{extent},
-    time_per_tick_{time_per_tick}
+    time_per_tick_{time_per_tick},
+    terrain_{WORLD_SEED},
+    storage_{save_directory},
+    writer_{chunks_, storage_, WritebackSettings{}},
+    physics_{chunks_, PhysicsSettings{}, [this](ChunkPos const pos) { return streamer_.blocks_ready(pos); }},
+    streamer_{jobs, chunks_, terrain_, &writer_, streaming}
 {
-    debug("World initalized");
+    glm::vec3 const spawn {8.f, static_cast<float>(terrain_.surface_height(8, 8) + 1), 8.f};
+    player_ = entities_.spawn(spawn, PLAYER_SIZE, Entities::COLLIDES);
+    debug("World initalized, streaming chunks around {} {} {}", spawn.x, spawn.y, spawn.z);
 }
 
-
 void World::tick(UserInput const& input) 
 {
-    camera_.update(player_position_, input.mouse_delta);
-    for (auto action : input.user_actions) 
+    PROFILE_SCOPE("tick");
+    using Clock = std::chrono::steady_clock;
+    auto const milliseconds = [](Clock::time_point const from, Clock::time_point const to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    };
+    auto const start = Clock::now();
+
+    auto const player = entities_.index(player_);
+    camera_.update(entities_.positions.get(player) + glm::vec3{0.f, EYE_HEIGHT, 0.f}, input.mouse_delta);
+    auto const walk = walk_velocity(input.user_actions, camera_.yaw);
+    entities_.velocities.x[player] = walk.x;
+    entities_.velocities.z[player] = walk.z;
+    auto const jump = std::find(input.user_actions.begin(), input.user_actions.end(), Action::Up) != input.user_actions.end();
+    if (jump and (entities_.flags()[player] & Entities::ON_GROUND)) entities_.velocities.y[player] = JUMP_SPEED;
+
+    entities_.move(time_per_tick_);
+    entities_.collide(physics_, time_per_tick_);
+    auto const moved = Clock::now();
+
+    streamer_.update(player_position());
+    if (lockstep_) streamer_.finish_jobs();
+    auto const streamed = Clock::now();
+
+    writer_.update();
+    tick_timings_ = {milliseconds(start, moved), milliseconds(moved, streamed), milliseconds(streamed, Clock::now())};
+}
+
+void World::place_player(glm::vec3 const& position)
+{
+    auto const player = entities_.index(player_);
+    entities_.positions.set(player, position);
+    entities_.velocities.set(player, glm::vec3{0.f});
+}
+
+uint64_t World::checksum() const
+{
+    Checksum checksum;
+    checksum.add(camera_.yaw);
+    checksum.add(camera_.pitch);
+    for (size_t idx{}; idx < entities_.size(); ++idx)
     {
-        player_position_ += calculate_movement(action, 0.003, camera_.yaw);
+        checksum.add(entities_.positions.get(idx));
+        checksum.add(entities_.velocities.get(idx));
+        checksum.add(entities_.flags()[idx]);
     }
+
+    // The map and the mesh handles are in whatever order loading happened to leave them
+    auto const by_position = [](ChunkPos const a, ChunkPos const b) { return a.x != b.x ? a.x < b.x : a.z < b.z; };
+    std::vector<Chunk const*> chunks {chunks_.begin(), chunks_.end()};
+    std::sort(chunks.begin(), chunks.end(), [&](Chunk const* a, Chunk const* b) { return by_position(a->pos(), b->pos()); });
+    std::vector<uint8_t> bytes;
+    for (auto const* chunk : chunks)
+    {
+        bytes.clear();
+        encode_chunk(*chunk, bytes);
+        checksum.add(chunk->pos());
+        checksum.add_all(bytes);
+        checksum.add(chunk->light_data());
+    }
+
+    std::vector<ChunkMesh const*> meshes;
+    for (auto const& mesh : streamer_.meshes())
+    {
+        if (mesh != nullptr) meshes.push_back(mesh.get());
+    }
+    std::sort(meshes.begin(), meshes.end(), [&](ChunkMesh const* a, ChunkMesh const* b) { return by_position(a->pos, b->pos); });
+    for (auto const* mesh : meshes)
+    {
+        checksum.add(mesh->pos);
+        checksum.add_all(mesh->vertices);
+        checksum.add_all(mesh->indices);
+    }
+    return checksum.value;
+}
+
+void World::set_block(glm::ivec3 const& position, Block const block)
+{
+    streamer_.edit(position, block);
+}
+
+std::optional<RayHit> World::target_block(float const reach) const
+{
+    return Raycaster{chunks_, [this](ChunkPos const pos) { return streamer_.blocks_ready(pos); }}.cast({camera_.position, camera_.target, reach});
 }
 
 RenderData World::to_render() const
@@ -90,10 +189,40 @@ RenderData World::to_render() const
     RenderData data
     {
         .camera = camera_,
-        .player_pos = player_position_,
-        .vertices = verticies,
-        .indices = indices,
+        .player_pos = player_position(),
+        .visible = {},
+        .updates = {},
+        .sequence = 0,
     };
     return data;
 }
 
+void World::to_render(RenderData& out, uint64_t const acknowledged)
+{
+    auto const meshes = streamer_.meshes();
+    std::erase_if(mesh_updates_, [&](MeshUpdate const& update) { return update.sequence <= acknowledged; });
+    for (auto const handle : streamer_.mesh_changes())
+    {
+        // Only the newest state of a handle matters, an older update still waiting is dropped
+        std::erase_if(mesh_updates_, [&](MeshUpdate const& update) { return update.handle == handle; });
+        mesh_updates_.push_back({++mesh_sequence_, handle, meshes[handle]});
+    }
+    streamer_.clear_mesh_changes();
+
+    out.camera = camera_;
+    out.player_pos = player_position();
+    out.updates.assign(mesh_updates_.begin(), mesh_updates_.end());
+    out.sequence = mesh_sequence_;
+
+    // Whole chunk columns against the frustum, empty meshes have nothing to draw anyway
+    Frustum const frustum{camera_};
+    out.visible.clear();
+    for (MeshHandle handle{}; handle < meshes.size(); ++handle)
+    {
+        auto const& mesh = meshes[handle];
+        if (mesh == nullptr or mesh->empty()) continue;
+        glm::vec3 const min {static_cast<float>(mesh->pos.x * SECTION_SIZE), 0.f, static_cast<float>(mesh->pos.z * SECTION_SIZE)};
+        if (frustum.intersects(min, min + glm::vec3{SECTION_SIZE, CHUNK_HEIGHT, SECTION_SIZE})) out.visible.push_back(handle);
+    }
+}
+
@@ -1,18 +1,101 @@
 #pragma once
 #include "camera.hpp"
+#include "entities.hpp"
 #include "interfaces.hpp"
+#include "jobs.hpp"
+#include "persist/storage.hpp"
+#include "persist/writer.hpp"
+#include "voxel/chunk_map.hpp"
+#include "voxel/physics.hpp"
+#include "voxel/raycast.hpp"
+#include "voxel/streamer.hpp"
+#include "worldgen/terrain.hpp"
 
 
+// Where the time of the last tick went, in milliseconds
+struct TickTimings
+{
+    // Input, entities and physics
+    double player{0.0};
+    double streaming{0.0};
+    double writeback{0.0};
+};
+
 class World 
 {
 public:
-    World(glm::uvec2 const& extent, float const time_per_tick);
+    static constexpr std::string_view SAVE_DIRECTORY {"saves/world"};
+
+    World(JobSystem& jobs, glm::uvec2 const& extent, float const time_per_tick, std::filesystem::path const& save_directory = SAVE_DIRECTORY,
+        StreamingSettings const& streaming = {});
     void tick(UserInput const& input);
-    RenderData to_render() const;
+    // Camera and player only, a first snapshot before any mesh is handed over
+    [[nodiscard]] RenderData to_render() const;
+    // Refills out, reusing the memory it already has. Mesh updates up to acknowledged are known to have
+    // reached the renderer, they are left out and forgotten
+    void to_render(RenderData& out, uint64_t const acknowledged);
+    // Every tick waits for the chunk jobs it started, so what the world does depends on nothing but the input
+    // it is given. Ticks take longer while chunks stream in
+    void set_lockstep(bool const lockstep)
+    {
+        lockstep_ = lockstep;
+    }
+
+    // Of the player, the camera, every loaded chunk's blocks and light and every mesh. The same inputs into a
+    // lockstep world give the same checksum, on the same build and CPU
+    [[nodiscard]] uint64_t checksum() const;
+
+    // Feet at position, standing still. For scripted paths, physics still runs on the next tick
+    void place_player(glm::vec3 const& position);
+
+    // Goes through the streamer, so it shows up in the meshes and gets saved a few ticks later
+    void set_block(glm::ivec3 const& position, Block const block);
+    // The block the camera looks at, if there is one within reach blocks
+    [[nodiscard]] std::optional<RayHit> target_block(float const reach) const;
+
+    [[nodiscard]] StreamingStats const& streaming_stats() const
+    {
+        return streamer_.stats();
+    }
+
+    [[nodiscard]] JobTimes const& job_times() const
+    {
+        return streamer_.job_times();
+    }
+
+    [[nodiscard]] TickTimings const& tick_timings() const
+    {
+        return tick_timings_;
+    }
+
+    [[nodiscard]] WritebackStats const& writeback_stats()
+    {
+        return writer_.stats();
+    }
 private:
+    // Feet of the player, the camera sits at eye height above
+    [[nodiscard]] glm::vec3 player_position() const
+    {
+        return entities_.positions.get(entities_.index(player_));
+    }
+
     PerspectiveCamera camera_;
+    // Not acknowledged by the renderer yet, in sequence order and one per handle at most
+    std::vector<MeshUpdate> mesh_updates_;
+    uint64_t mesh_sequence_{0};
+    // Seconds
     float time_per_tick_;
-    glm::vec3 player_position_{-2.f, .0f, .0f};
+    Entities entities_;
+    EntityId player_;
     uint32_t tick_number{0};
+    bool lockstep_{false};
+    TickTimings tick_timings_;
+    ChunkMap chunks_;
+    TerrainGenerator terrain_;
+    RegionStorage storage_;
+    ChunkWriter writer_;
+    Physics physics_;
+    // Declared last, it waits for its jobs before the chunks they use go away
+    ChunkStreamer streamer_;
 
 };
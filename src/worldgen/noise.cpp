@@ -0,0 +1,157 @@
+#include <bit>
+#include <cmath>
+#include "utils.hpp"
+#include "worldgen/noise_kernel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NOISE_X86
+#include <emmintrin.h>
+#endif
+
+#ifdef NOISE_X86
+// Defined in noise_avx2.cpp, the only file built with AVX2 enabled
+NoiseKernels avx2_noise_kernels();
+#endif
+
+namespace
+{
+
+// Reference implementation, also what non x86 builds run
+struct ScalarLanes
+{
+    using F = float;
+    using I = uint32_t;
+    static constexpr int WIDTH {1};
+
+    static F splat(float const value) { return value; }
+    static I splat_int(uint32_t const value) { return value; }
+    static F lane_offsets() { return 0.f; }
+    static F add(F const a, F const b) { return a + b; }
+    static F sub(F const a, F const b) { return a - b; }
+    static F mul(F const a, F const b) { return a * b; }
+    static F floor(F const value) { return std::floor(value); }
+    static I to_int(F const value) { return static_cast<uint32_t>(static_cast<int32_t>(value)); }
+    static I add_int(I const a, I const b) { return a + b; }
+    static I mul_int(I const a, I const b) { return a * b; }
+    static I bit_and(I const a, I const b) { return a & b; }
+    static I bit_or(I const a, I const b) { return a | b; }
+    static I bit_xor(I const a, I const b) { return a ^ b; }
+    static I shift_left(I const value, int const bits) { return value << bits; }
+    static I shift_right(I const value, int const bits) { return value >> bits; }
+    static I less(I const a, I const b) { return static_cast<int32_t>(a) < static_cast<int32_t>(b) ? ~0u : 0u; }
+    static I equal(I const a, I const b) { return a == b ? ~0u : 0u; }
+    static F select(I const mask, F const if_set, F const if_clear) { return mask != 0 ? if_set : if_clear; }
+    static F flip_sign(F const value, I const sign) { return std::bit_cast<float>(std::bit_cast<uint32_t>(value) ^ (sign & 0x80000000u)); }
+    static void store(float* out, F const value) { *out = value; }
+};
+
+#ifdef NOISE_X86
+struct Sse2Lanes
+{
+    using F = __m128;
+    using I = __m128i;
+    static constexpr int WIDTH {4};
+
+    static F splat(float const value) { return _mm_set1_ps(value); }
+    static I splat_int(uint32_t const value) { return _mm_set1_epi32(static_cast<int32_t>(value)); }
+    static F lane_offsets() { return _mm_setr_ps(0.f, 1.f, 2.f, 3.f); }
+    static F add(F const a, F const b) { return _mm_add_ps(a, b); }
+    static F sub(F const a, F const b) { return _mm_sub_ps(a, b); }
+    static F mul(F const a, F const b) { return _mm_mul_ps(a, b); }
+
+    // No roundps before SSE4.1: truncate, then step down where truncation rounded up
+    static F floor(F const value)
+    {
+        auto const truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+        auto const rounded_up = _mm_cmpgt_ps(truncated, value);
+        return _mm_sub_ps(truncated, _mm_and_ps(rounded_up, _mm_set1_ps(1.f)));
+    }
+
+    static I to_int(F const value) { return _mm_cvttps_epi32(value); }
+    static I add_int(I const a, I const b) { return _mm_add_epi32(a, b); }
+
+    // No pmulld before SSE4.1 either, multiply even and odd lanes to 64 bits and keep the low halves
+    static I mul_int(I const a, I const b)
+    {
+        auto const even = _mm_mul_epu32(a, b);
+        auto const odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    static I bit_and(I const a, I const b) { return _mm_and_si128(a, b); }
+    static I bit_or(I const a, I const b) { return _mm_or_si128(a, b); }
+    static I bit_xor(I const a, I const b) { return _mm_xor_si128(a, b); }
+    static I shift_left(I const value, int const bits) { return _mm_slli_epi32(value, bits); }
+    static I shift_right(I const value, int const bits) { return _mm_srli_epi32(value, bits); }
+    static I less(I const a, I const b) { return _mm_cmplt_epi32(a, b); }
+    static I equal(I const a, I const b) { return _mm_cmpeq_epi32(a, b); }
+
+    static F select(I const mask, F const if_set, F const if_clear)
+    {
+        auto const lanes = _mm_castsi128_ps(mask);
+        return _mm_or_ps(_mm_and_ps(lanes, if_set), _mm_andnot_ps(lanes, if_clear));
+    }
+
+    static F flip_sign(F const value, I const sign)
+    {
+        return _mm_xor_ps(value, _mm_castsi128_ps(_mm_and_si128(sign, _mm_set1_epi32(static_cast<int32_t>(0x80000000u)))));
+    }
+
+    static void store(float* out, F const value) { _mm_storeu_ps(out, value); }
+};
+#endif
+
+NoiseKernels select_kernels(SimdLevel const level)
+{
+    switch (level)
+    {
+#ifdef NOISE_X86
+        case SimdLevel::Avx2: return avx2_noise_kernels();
+        case SimdLevel::Sse2: return kernels<Sse2Lanes>();
+#endif
+        default: return kernels<ScalarLanes>();
+    }
+}
+
+} // namespace
+
+SimdLevel detect_simd_level()
+{
+#ifdef NOISE_X86
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+    return SimdLevel::Sse2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+uint32_t simd_width(SimdLevel const level)
+{
+    switch (level)
+    {
+        case SimdLevel::Avx2: return 8;
+        case SimdLevel::Sse2: return 4;
+        default: return 1;
+    }
+}
+
+Noise::Noise(NoiseSettings const& settings, SimdLevel const level) :
+    settings_{settings},
+    level_{std::min(level, detect_simd_level())},
+    kernels_{select_kernels(level_)}
+{}
+
+void Noise::fill_2d(glm::vec2 const origin, float const step, glm::ivec2 const size, std::span<float> out) const
+{
+    if (out.size() < static_cast<size_t>(size.x * size.y)) fail("Noise output holds {} samples, {}x{} needed", out.size(), size.x, size.y);
+    kernels_.fill_2d(settings_, origin, step, size, out.data());
+}
+
+void Noise::fill_3d(glm::vec3 const origin, float const step, glm::ivec3 const size, std::span<float> out) const
+{
+    if (out.size() < static_cast<size_t>(size.x * size.y * size.z))
+    {
+        fail("Noise output holds {} samples, {}x{}x{} needed", out.size(), size.x, size.y, size.z);
+    }
+    kernels_.fill_3d(settings_, origin, step, size, out.data());
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <glm/glm.hpp>
+
+enum class SimdLevel : uint8_t
+{
+    Scalar,
+    Sse2,
+    Avx2,
+};
+
+// Best level the running CPU supports
+[[nodiscard]] SimdLevel detect_simd_level();
+[[nodiscard]] uint32_t simd_width(SimdLevel const level);
+
+struct NoiseSettings
+{
+    uint32_t seed{0};
+    // Features per block of the first octave
+    float frequency{1.f / 64.f};
+    uint32_t octaves{1};
+    float lacunarity{2.f};
+    float gain{0.5f};
+};
+
+// One SIMD level worth of grid filling kernels, see noise_kernel.hpp
+struct NoiseKernels
+{
+    void (*fill_2d)(NoiseSettings const& settings, glm::vec2 origin, float step, glm::ivec2 size, float* out);
+    void (*fill_3d)(NoiseSettings const& settings, glm::vec3 origin, float step, glm::ivec3 size, float* out);
+};
+
+// Seeded gradient noise summed over octaves (fBm), values roughly in [-1, 1].
+// Samples are taken on regular grids, a whole heightmap or section per call, as many points at once
+// as there are SIMD lanes. Every level runs the same float operations in the same order,
+// so results are bit identical whichever one the CPU ends up using.
+class Noise
+{
+public:
+    explicit Noise(NoiseSettings const& settings, SimdLevel const level = detect_simd_level());
+
+    // size.x * size.y samples starting at origin, x fastest
+    void fill_2d(glm::vec2 const origin, float const step, glm::ivec2 const size, std::span<float> out) const;
+    // size.x * size.y * size.z samples, x fastest, then z, then y, same order as blocks in a section
+    void fill_3d(glm::vec3 const origin, float const step, glm::ivec3 const size, std::span<float> out) const;
+
+    [[nodiscard]] SimdLevel level() const
+    {
+        return level_;
+    }
+
+private:
+    NoiseSettings settings_;
+    SimdLevel level_;
+    NoiseKernels kernels_;
+};
@@ -0,0 +1,47 @@
+// Built with -mavx2 (see meson.build), only reached after detect_simd_level() found AVX2.
+// FMA stays disabled so products and sums round exactly like the narrower levels.
+#include <immintrin.h>
+#include "worldgen/noise_kernel.hpp"
+
+namespace
+{
+
+struct Avx2Lanes
+{
+    using F = __m256;
+    using I = __m256i;
+    static constexpr int WIDTH {8};
+
+    static F splat(float const value) { return _mm256_set1_ps(value); }
+    static I splat_int(uint32_t const value) { return _mm256_set1_epi32(static_cast<int32_t>(value)); }
+    static F lane_offsets() { return _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f); }
+    static F add(F const a, F const b) { return _mm256_add_ps(a, b); }
+    static F sub(F const a, F const b) { return _mm256_sub_ps(a, b); }
+    static F mul(F const a, F const b) { return _mm256_mul_ps(a, b); }
+    static F floor(F const value) { return _mm256_floor_ps(value); }
+    static I to_int(F const value) { return _mm256_cvttps_epi32(value); }
+    static I add_int(I const a, I const b) { return _mm256_add_epi32(a, b); }
+    static I mul_int(I const a, I const b) { return _mm256_mullo_epi32(a, b); }
+    static I bit_and(I const a, I const b) { return _mm256_and_si256(a, b); }
+    static I bit_or(I const a, I const b) { return _mm256_or_si256(a, b); }
+    static I bit_xor(I const a, I const b) { return _mm256_xor_si256(a, b); }
+    static I shift_left(I const value, int const bits) { return _mm256_slli_epi32(value, bits); }
+    static I shift_right(I const value, int const bits) { return _mm256_srli_epi32(value, bits); }
+    static I less(I const a, I const b) { return _mm256_cmpgt_epi32(b, a); }
+    static I equal(I const a, I const b) { return _mm256_cmpeq_epi32(a, b); }
+    static F select(I const mask, F const if_set, F const if_clear) { return _mm256_blendv_ps(if_clear, if_set, _mm256_castsi256_ps(mask)); }
+
+    static F flip_sign(F const value, I const sign)
+    {
+        return _mm256_xor_ps(value, _mm256_castsi256_ps(_mm256_and_si256(sign, _mm256_set1_epi32(static_cast<int32_t>(0x80000000u)))));
+    }
+
+    static void store(float* out, F const value) { _mm256_storeu_ps(out, value); }
+};
+
+} // namespace
+
+NoiseKernels avx2_noise_kernels()
+{
+    return kernels<Avx2Lanes>();
+}
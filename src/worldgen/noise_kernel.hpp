@@ -0,0 +1,217 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include "worldgen/noise.hpp"
+
+// Noise written once against a lane type L, included by each noise translation unit with its own L
+// and its own instruction set. Everything is in an unnamed namespace on purpose: with regular inline
+// templates the linker could keep the copy compiled for AVX2 and hand it to callers on older CPUs.
+//
+// L provides F (WIDTH floats) and I (WIDTH 32 bit integers) with:
+//   splat, splat_int, lane_offsets (0, 1, 2...), add, sub, mul, floor, to_int (of already floored values),
+//   add_int, mul_int, bit_and, bit_or, bit_xor, shift_left, shift_right (logical),
+//   less, equal (all bits set where true), select(mask, if_set, if_clear), flip_sign(value, sign bit source), store
+namespace
+{
+
+constexpr uint32_t PRIME_X {0x9E3779B1u};
+constexpr uint32_t PRIME_Y {0x85EBCA77u};
+constexpr uint32_t PRIME_Z {0xC2B2AE3Du};
+constexpr uint32_t OCTAVE_SEED_STEP {0x27D4EB2Fu};
+
+template <typename L>
+typename L::I mix(typename L::I hash)
+{
+    hash = L::bit_xor(hash, L::shift_right(hash, 16));
+    hash = L::mul_int(hash, L::splat_int(0x7FEB352Du));
+    hash = L::bit_xor(hash, L::shift_right(hash, 15));
+    hash = L::mul_int(hash, L::splat_int(0x846CA68Bu));
+    return L::bit_xor(hash, L::shift_right(hash, 16));
+}
+
+template <typename L>
+typename L::F fade(typename L::F const t)
+{
+    auto const polynomial = L::add(L::mul(t, L::sub(L::mul(t, L::splat(6.f)), L::splat(15.f))), L::splat(10.f));
+    return L::mul(L::mul(L::mul(t, t), t), polynomial);
+}
+
+template <typename L>
+typename L::F lerp(typename L::F const from, typename L::F const to, typename L::F const t)
+{
+    return L::add(from, L::mul(t, L::sub(to, from)));
+}
+
+// Dot product with one of 8 gradients (+-1, +-2) and (+-2, +-1)
+template <typename L>
+typename L::F gradient_dot(typename L::I const hash, typename L::F const x, typename L::F const y)
+{
+    auto const swap = L::less(L::bit_and(hash, L::splat_int(7)), L::splat_int(4));
+    auto const u = L::select(swap, x, y);
+    auto const v = L::select(swap, y, x);
+    auto const doubled = L::flip_sign(v, L::shift_left(hash, 30));
+    return L::add(L::flip_sign(u, L::shift_left(hash, 31)), L::add(doubled, doubled));
+}
+
+// Dot product with one of the 12 cube edge gradients, picked from 16 like improved Perlin noise does
+template <typename L>
+typename L::F gradient_dot(typename L::I const hash, typename L::F const x, typename L::F const y, typename L::F const z)
+{
+    auto const low = L::bit_and(hash, L::splat_int(15));
+    auto const u = L::select(L::less(low, L::splat_int(8)), x, y);
+    auto const x_instead_of_z = L::bit_or(L::equal(low, L::splat_int(12)), L::equal(low, L::splat_int(14)));
+    auto const v = L::select(L::less(low, L::splat_int(4)), y, L::select(x_instead_of_z, x, z));
+    return L::add(L::flip_sign(u, L::shift_left(hash, 31)), L::flip_sign(v, L::shift_left(hash, 30)));
+}
+
+template <typename L>
+typename L::F gradient_noise(typename L::F const x, typename L::F const y, typename L::I const seed)
+{
+    auto const floor_x = L::floor(x);
+    auto const floor_y = L::floor(y);
+    auto const x0 = L::sub(x, floor_x);
+    auto const y0 = L::sub(y, floor_y);
+    auto const x1 = L::sub(x0, L::splat(1.f));
+    auto const y1 = L::sub(y0, L::splat(1.f));
+
+    // Lattice coordinates are multiplied once, neighbours are one prime further
+    auto const hash_x0 = L::mul_int(L::to_int(floor_x), L::splat_int(PRIME_X));
+    auto const hash_y0 = L::bit_xor(L::mul_int(L::to_int(floor_y), L::splat_int(PRIME_Y)), seed);
+    auto const hash_x1 = L::add_int(hash_x0, L::splat_int(PRIME_X));
+    auto const hash_y1 = L::add_int(hash_y0, L::splat_int(PRIME_Y));
+
+    auto const n00 = gradient_dot<L>(mix<L>(L::bit_xor(hash_x0, hash_y0)), x0, y0);
+    auto const n10 = gradient_dot<L>(mix<L>(L::bit_xor(hash_x1, hash_y0)), x1, y0);
+    auto const n01 = gradient_dot<L>(mix<L>(L::bit_xor(hash_x0, hash_y1)), x0, y1);
+    auto const n11 = gradient_dot<L>(mix<L>(L::bit_xor(hash_x1, hash_y1)), x1, y1);
+
+    auto const u = fade<L>(x0);
+    auto const v = fade<L>(y0);
+    // The 2D gradients are twice as long as the 3D ones
+    return L::mul(lerp<L>(lerp<L>(n00, n10, u), lerp<L>(n01, n11, u), v), L::splat(0.5f));
+}
+
+template <typename L>
+typename L::F gradient_noise(typename L::F const x, typename L::F const y, typename L::F const z, typename L::I const seed)
+{
+    using F = typename L::F;
+    auto const floor_x = L::floor(x);
+    auto const floor_y = L::floor(y);
+    auto const floor_z = L::floor(z);
+    auto const x0 = L::sub(x, floor_x);
+    auto const y0 = L::sub(y, floor_y);
+    auto const z0 = L::sub(z, floor_z);
+    auto const x1 = L::sub(x0, L::splat(1.f));
+    auto const y1 = L::sub(y0, L::splat(1.f));
+    auto const z1 = L::sub(z0, L::splat(1.f));
+
+    auto const hash_x0 = L::mul_int(L::to_int(floor_x), L::splat_int(PRIME_X));
+    auto const hash_y0 = L::mul_int(L::to_int(floor_y), L::splat_int(PRIME_Y));
+    auto const hash_z0 = L::bit_xor(L::mul_int(L::to_int(floor_z), L::splat_int(PRIME_Z)), seed);
+    auto const hash_x1 = L::add_int(hash_x0, L::splat_int(PRIME_X));
+    auto const hash_y1 = L::add_int(hash_y0, L::splat_int(PRIME_Y));
+    auto const hash_z1 = L::add_int(hash_z0, L::splat_int(PRIME_Z));
+
+    auto const corner = [](auto const hash_x, auto const hash_y, auto const hash_z, F const dx, F const dy, F const dz) {
+        return gradient_dot<L>(mix<L>(L::bit_xor(L::bit_xor(hash_x, hash_y), hash_z)), dx, dy, dz);
+    };
+    auto const n000 = corner(hash_x0, hash_y0, hash_z0, x0, y0, z0);
+    auto const n100 = corner(hash_x1, hash_y0, hash_z0, x1, y0, z0);
+    auto const n010 = corner(hash_x0, hash_y1, hash_z0, x0, y1, z0);
+    auto const n110 = corner(hash_x1, hash_y1, hash_z0, x1, y1, z0);
+    auto const n001 = corner(hash_x0, hash_y0, hash_z1, x0, y0, z1);
+    auto const n101 = corner(hash_x1, hash_y0, hash_z1, x1, y0, z1);
+    auto const n011 = corner(hash_x0, hash_y1, hash_z1, x0, y1, z1);
+    auto const n111 = corner(hash_x1, hash_y1, hash_z1, x1, y1, z1);
+
+    auto const u = fade<L>(x0);
+    auto const v = fade<L>(y0);
+    auto const w = fade<L>(z0);
+    auto const front = lerp<L>(lerp<L>(n000, n100, u), lerp<L>(n010, n110, u), v);
+    auto const back = lerp<L>(lerp<L>(n001, n101, u), lerp<L>(n011, n111, u), v);
+    return lerp<L>(front, back, w);
+}
+
+// fBm, the per octave factors are computed in scalar so every lane width sees the exact same constants
+template <typename L, typename... Coords>
+typename L::F fractal(NoiseSettings const& settings, Coords const... coords)
+{
+    auto sum = L::splat(0.f);
+    auto frequency = settings.frequency;
+    auto amplitude = 1.f;
+    auto total = 0.f;
+    for (uint32_t octave{}; octave < settings.octaves; ++octave)
+    {
+        auto const seed = L::splat_int(settings.seed + octave * OCTAVE_SEED_STEP);
+        auto const scale = L::splat(frequency);
+        auto const value = gradient_noise<L>(L::mul(coords, scale)..., seed);
+        sum = L::add(sum, L::mul(value, L::splat(amplitude)));
+        total += amplitude;
+        amplitude *= settings.gain;
+        frequency *= settings.lacunarity;
+    }
+    return L::mul(sum, L::splat(1.f / std::max(total, 1e-6f)));
+}
+
+// Writes a run of `count` lanes, the last vector of a row may be partial
+template <typename L>
+void store(float* out, typename L::F const value, int const count)
+{
+    if (count >= L::WIDTH)
+    {
+        L::store(out, value);
+        return;
+    }
+    std::array<float, L::WIDTH> lanes;
+    L::store(lanes.data(), value);
+    std::copy_n(lanes.begin(), std::min(count, L::WIDTH), out);
+}
+
+// Row start plus lane offsets, every width ends up with origin + (x + lane) * step for each sample
+template <typename L>
+typename L::F row_coordinates(float const origin, int const x, float const step)
+{
+    return L::add(L::splat(origin), L::mul(L::add(L::splat(static_cast<float>(x)), L::lane_offsets()), L::splat(step)));
+}
+
+template <typename L>
+void fill_2d(NoiseSettings const& settings, glm::vec2 const origin, float const step, glm::ivec2 const size, float* out)
+{
+    for (int y{}; y < size.y; ++y)
+    {
+        auto const row_y = L::splat(origin.y + static_cast<float>(y) * step);
+        for (int x{}; x < size.x; x += L::WIDTH)
+        {
+            auto const value = fractal<L>(settings, row_coordinates<L>(origin.x, x, step), row_y);
+            store<L>(out + x, value, std::min(L::WIDTH, size.x - x));
+        }
+        out += size.x;
+    }
+}
+
+template <typename L>
+void fill_3d(NoiseSettings const& settings, glm::vec3 const origin, float const step, glm::ivec3 const size, float* out)
+{
+    for (int y{}; y < size.y; ++y)
+    {
+        auto const row_y = L::splat(origin.y + static_cast<float>(y) * step);
+        for (int z{}; z < size.z; ++z)
+        {
+            auto const row_z = L::splat(origin.z + static_cast<float>(z) * step);
+            for (int x{}; x < size.x; x += L::WIDTH)
+            {
+                auto const value = fractal<L>(settings, row_coordinates<L>(origin.x, x, step), row_y, row_z);
+                store<L>(out + x, value, std::min(L::WIDTH, size.x - x));
+            }
+            out += size.x;
+        }
+    }
+}
+
+template <typename L>
+constexpr NoiseKernels kernels()
+{
+    return {fill_2d<L>, fill_3d<L>};
+}
+
+} // namespace
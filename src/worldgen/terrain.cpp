@@ -0,0 +1,74 @@
+#include <algorithm>
+#include "worldgen/terrain.hpp"
+
+namespace
+{
+
+constexpr int COLUMNS {SECTION_SIZE * SECTION_SIZE};
+
+} // namespace
+
+TerrainGenerator::TerrainGenerator(uint32_t const seed) :
+    height_{{.seed = seed, .frequency = 1.f / 160.f, .octaves = 5}},
+    caves_{{.seed = seed ^ 0x5EEDCAFEu, .frequency = 1.f / 40.f, .octaves = 2}}
+{}
+
+void TerrainGenerator::generate(Chunk& chunk) const
+{
+    auto const origin_x = static_cast<float>(chunk.pos().x * SECTION_SIZE);
+    auto const origin_z = static_cast<float>(chunk.pos().z * SECTION_SIZE);
+
+    std::array<float, COLUMNS> height_noise;
+    height_.fill_2d({origin_x, origin_z}, 1.f, {SECTION_SIZE, SECTION_SIZE}, height_noise);
+    std::array<int, COLUMNS> heights;
+    std::transform(height_noise.begin(), height_noise.end(), heights.begin(), to_height);
+    auto const [lowest, highest] = std::minmax_element(heights.begin(), heights.end());
+
+    std::array<float, SECTION_VOLUME> cave_noise;
+    for (size_t idx{}; idx < SECTIONS_PER_CHUNK; ++idx)
+    {
+        auto const base = static_cast<int>(idx) * SECTION_SIZE;
+        if (base > *highest) break;
+
+        auto& section = chunk.section(idx);
+        caves_.fill_3d({origin_x, static_cast<float>(base), origin_z}, 1.f, {SECTION_SIZE, SECTION_SIZE, SECTION_SIZE}, cave_noise);
+
+        // Deep sections without caves are a single fill and stay uniform
+        auto const solid = base + SECTION_SIZE <= *lowest - SOIL_DEPTH
+            and std::none_of(cave_noise.begin(), cave_noise.end(), [](float const value) { return value > CAVE_THRESHOLD; });
+        if (solid)
+        {
+            section.fill(Block::Stone);
+            continue;
+        }
+
+        for (int y{}; y < SECTION_SIZE; ++y)
+        {
+            auto const height = base + y;
+            for (int z{}; z < SECTION_SIZE; ++z)
+            {
+                for (int x{}; x < SECTION_SIZE; ++x)
+                {
+                    auto const surface = heights[static_cast<size_t>(z * SECTION_SIZE + x)];
+                    if (height > surface) continue;
+                    // Cave noise comes out in section order: x, then z, then y
+                    auto const cave = cave_noise[static_cast<size_t>((y * SECTION_SIZE + z) * SECTION_SIZE + x)] > CAVE_THRESHOLD;
+                    if (cave and height > 0) continue;
+
+                    auto block = Block::Stone;
+                    if (height == surface) block = surface < SAND_LEVEL ? Block::Sand : Block::Grass;
+                    else if (height > surface - SOIL_DEPTH) block = surface < SAND_LEVEL ? Block::Sand : Block::Dirt;
+                    section.set(x, y, z, block);
+                }
+            }
+        }
+    }
+    chunk.compact();
+}
+
+int TerrainGenerator::surface_height(int const x, int const z) const
+{
+    float noise{};
+    height_.fill_2d({static_cast<float>(x), static_cast<float>(z)}, 1.f, {1, 1}, {&noise, 1});
+    return to_height(noise);
+}
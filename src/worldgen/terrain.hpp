@@ -0,0 +1,32 @@
+#pragma once
+#include "voxel/chunk.hpp"
+#include "worldgen/noise.hpp"
+
+// Fills chunks from noise: a fBm heightmap gives the surface, 3D noise carves caves below it.
+// Holds no mutable state, so any number of generation jobs can share one generator.
+class TerrainGenerator
+{
+public:
+    explicit TerrainGenerator(uint32_t const seed);
+
+    // Expects a freshly created, all air chunk
+    void generate(Chunk& chunk) const;
+
+    // Height of the topmost solid block of the column at world coordinates x, z
+    [[nodiscard]] int surface_height(int const x, int const z) const;
+
+private:
+    static constexpr int BASE_HEIGHT {64};
+    static constexpr int HEIGHT_RANGE {48};
+    static constexpr int SAND_LEVEL {58};
+    static constexpr int SOIL_DEPTH {4};
+    static constexpr float CAVE_THRESHOLD {0.22f};
+
+    [[nodiscard]] static int to_height(float const noise)
+    {
+        return BASE_HEIGHT + static_cast<int>(noise * HEIGHT_RANGE);
+    }
+
+    Noise height_;
+    Noise caves_;
+};